@@ -29,6 +29,11 @@ void ADSREnvelope::noteOff() {
     }
 }
 
+void ADSREnvelope::reset() {
+    currentState = Idle;
+    currentLevel = 0.0f;
+}
+
 float ADSREnvelope::getNextSample() {
     switch (currentState) {
         case Idle:
@@ -9,6 +9,7 @@ public:
     void setSampleRate(float newSampleRate);
     void noteOn();
     void noteOff();
+    void reset(); // Jump straight to Idle at zero level
     float getNextSample();
     
     // Parameter setters
@@ -21,6 +22,7 @@ public:
     bool isActive() const;
     bool isInAttack() const;
     bool isInRelease() const;
+    float getCurrentLevel() const { return currentLevel; }
     
     // Quick setup
     void setADSR(float attackMs, float decayMs, float sustainLevel, float releaseMs);
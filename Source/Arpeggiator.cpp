@@ -5,155 +5,244 @@ Arpeggiator::Arpeggiator() {}
 void Arpeggiator::prepare(double newSampleRate)
 {
     sampleRate = newSampleRate;
-    calculateStepSamples();
+    stepClock.reset();
+    expectedPosition = 0.0;
+    passThrough.ensureSize(2048);
 }
 
 void Arpeggiator::process(juce::MidiBuffer& midiMessages, juce::MidiBuffer& outputBuffer, int numSamples)
 {
     if (!isEnabled) {
-        outputBuffer = midiMessages;
+        // Switched off: end the note it was playing and forget the held ones, which it
+        // no longer sees released
+        if (playingNote >= 0) {
+            noteOff(outputBuffer, playingNote, 0);
+            playingNote = -1;
+        }
+        heldNotes = {};
+        patternLength = 0;
         return;
     }
     
-    // Process input MIDI to track held notes
+    // Track held notes; everything else, note-offs for notes it isn't holding among
+    // them, stays in midiMessages
+    passThrough.clear();
     for (const auto metadata : midiMessages) {
         auto message = metadata.getMessage();
         if (message.isNoteOn()) {
-            heldNotes.add(message.getNoteNumber());
-        } else if (message.isNoteOff()) {
-            heldNotes.removeValue(message.getNoteNumber());
+            addHeldNote(message.getNoteNumber(), message.getVelocity());
+        } else if (message.isNoteOff() && isHeld(message.getNoteNumber())) {
+            removeHeldNote(message.getNoteNumber());
+        } else {
+            // Including note-offs for keys held down before it was switched on, whose
+            // note-ons already reached the synth
+            passThrough.addEvent(message, metadata.samplePosition);
         }
     }
+    midiMessages.swapWith(passThrough); // Keeps both buffers' preallocated storage
     
-    // Build pattern if notes changed
-    if (heldNotes.size() > 0 && (currentPatternNotes.isEmpty() || heldNotes.size() != currentPatternNotes.size())) {
-        buildPatternNotes();
+    // Where this block sits on the step clock. Synced to a playing host it's the host's
+    // PPQ; otherwise the internal clock, running at the host tempo (synced) or so that
+    // one step lasts 1/rate seconds (free).
+    const double stepBeats = getStepBeats();
+    const bool followHost = syncToHost && hostIsPlaying;
+    const double beatsPerSample = followHost || syncToHost ? hostBPM / (60.0 * sampleRate)
+                                                           : rate * stepBeats / sampleRate;
+    stepClock.beginBlock(followHost, hostPPQ, beatsPerSample, stepBeats, swing, numSamples);
+    const double blockStart = stepClock.getBlockStart();
+    
+    // The host jumped (loop, relocate): forget which steps have played, and don't leave
+    // the sounding note waiting for a gate position that may now be in the future. PPQ
+    // jitter and tempo ramps move a block by far less than half a step.
+    if (std::abs(blockStart - expectedPosition) > 0.5 * stepBeats) {
+        stepClock.setLastStepIndex(stepClock.getStepIndexAt(blockStart) - 1);
+        playingNoteOff = blockStart;
     }
+    expectedPosition = stepClock.getBlockEnd();
     
-    // Process arpeggiator
-    for (int sample = 0; sample < numSamples; ++sample) {
-        if (currentSample >= samplesPerStep) {
-            currentSample = 0;
-            
-            // Turn off previous note
-            if (currentStep < currentPatternNotes.size()) {
-                int noteToTurnOff = currentPatternNotes[currentStep] + (currentOctave * 12);
-                noteOff(outputBuffer, noteToTurnOff, sample);
-            }
-            
-            // Move to next step
-            currentStep = getNextNote();
-            
-            // Turn on new note
-            if (currentStep < currentPatternNotes.size()) {
-                int noteToPlay = currentPatternNotes[currentStep] + (currentOctave * 12);
-                noteOn(outputBuffer, noteToPlay, 100, sample);
-            }
+    stepClock.forEachStep([&](juce::int64, double stepStart, double stepLength) {
+        // Gate closing before this step
+        if (playingNote >= 0 && playingNoteOff < stepStart) {
+            noteOff(outputBuffer, playingNote, stepClock.toSampleOffset(playingNoteOff));
+            playingNote = -1;
         }
-        currentSample++;
+        
+        advanceStep(outputBuffer, stepClock.toSampleOffset(stepStart), stepStart + gate * stepLength);
+    });
+    
+    if (playingNote >= 0 && playingNoteOff < stepClock.getBlockEnd()) {
+        noteOff(outputBuffer, playingNote, stepClock.toSampleOffset(playingNoteOff));
+        playingNote = -1;
+    }
+}
+
+void Arpeggiator::advanceStep(juce::MidiBuffer& buffer, int sampleOffset, double noteOffPosition)
+{
+    // A full gate ties into this step, so the previous note ends where the new one starts
+    if (playingNote >= 0) {
+        noteOff(buffer, playingNote, sampleOffset);
+        playingNote = -1;
     }
     
-    midiMessages.clear();
+    if (patternLength == 0) {
+        return;
+    }
+    
+    currentStep = getNextNote();
+    
+    const int patternNote = patternNotes[static_cast<size_t>(currentStep)];
+    const int noteToPlay = patternNote + currentOctave * 12;
+    if (noteToPlay > 127) {
+        return;
+    }
+    
+    noteOn(buffer, noteToPlay, heldVelocities[static_cast<size_t>(patternNote)], sampleOffset);
+    playingNote = noteToPlay;
+    playingNoteOff = noteOffPosition;
 }
 
-void Arpeggiator::setHostInfo(double bpm, bool isPlaying)
+void Arpeggiator::setTransportPosition(double bpm, double ppqPosition, bool isPlaying)
 {
-    hostBPM = bpm;
+    // A host that starts playing takes over the clock straight away
+    if (isPlaying && !hostIsPlaying) {
+        stepClock.setLastStepIndex(static_cast<juce::int64>(std::floor(ppqPosition / getStepBeats())) - 1);
+    }
+    
+    hostBPM = bpm > 0.0 ? bpm : 120.0;
+    hostPPQ = ppqPosition;
     hostIsPlaying = isPlaying;
-    if (syncToHost && isPlaying) {
-        calculateStepSamples();
+}
+
+double Arpeggiator::getStepBeats() const
+{
+    return getDivisionBeats(division);
+}
+
+double Arpeggiator::getDivisionBeats(Division division)
+{
+    static constexpr double beats[DIVISION_COUNT] = {
+        1.0, 1.5, 2.0 / 3.0,            // 1/4, 1/4D, 1/4T
+        0.5, 0.75, 1.0 / 3.0,           // 1/8, 1/8D, 1/8T
+        0.25, 0.375, 1.0 / 6.0,         // 1/16, 1/16D, 1/16T
+        0.125, 0.1875, 1.0 / 12.0       // 1/32, 1/32D, 1/32T
+    };
+    return beats[juce::jlimit(0, DIVISION_COUNT - 1, static_cast<int>(division))];
+}
+
+juce::StringArray Arpeggiator::getDivisionNames()
+{
+    return { "1/4", "1/4D", "1/4T",
+             "1/8", "1/8D", "1/8T",
+             "1/16", "1/16D", "1/16T",
+             "1/32", "1/32D", "1/32T" };
+}
+
+void Arpeggiator::setPattern(Pattern pattern)
+{
+    if (pattern != currentPattern) {
+        currentPattern = pattern;
+        buildPatternNotes();
     }
 }
 
-void Arpeggiator::calculateStepSamples()
+int Arpeggiator::getNumHeldNotes() const noexcept
 {
-    if (syncToHost && hostIsPlaying) {
-        // Sync to host BPM (1/16 notes)
-        double secondsPerBeat = 60.0 / hostBPM;
-        double secondsPerStep = secondsPerBeat / 4.0; // 1/16 notes
-        samplesPerStep = static_cast<int>(secondsPerStep * sampleRate);
-    } else {
-        // Free rate
-        double secondsPerStep = 1.0 / rate;
-        samplesPerStep = static_cast<int>(secondsPerStep * sampleRate);
+    return juce::countNumberOfBits(heldNotes[0]) + juce::countNumberOfBits(heldNotes[1]);
+}
+
+void Arpeggiator::addHeldNote(int note, int velocity)
+{
+    const bool wasHeld = isHeld(note);
+    heldNotes[static_cast<size_t>(note >> 6)] |= juce::uint64(1) << (note & 63);
+    heldVelocities[static_cast<size_t>(note)] = static_cast<juce::uint8>(juce::jlimit(1, 127, velocity));
+    
+    if (wasHeld) {
+        return;
     }
+    
+    // Random keeps its order when notes change, a new note lands at a random place
+    if (currentPattern == RANDOM && patternLength < maxPatternLength) {
+        const int position = random.nextInt(patternLength + 1);
+        std::copy_backward(patternNotes.begin() + position, patternNotes.begin() + patternLength,
+                           patternNotes.begin() + patternLength + 1);
+        patternNotes[static_cast<size_t>(position)] = static_cast<juce::uint8>(note);
+        ++patternLength;
+        return;
+    }
+    
+    buildPatternNotes();
+}
+
+void Arpeggiator::removeHeldNote(int note)
+{
+    if (!isHeld(note)) {
+        return;
+    }
+    
+    heldNotes[static_cast<size_t>(note >> 6)] &= ~(juce::uint64(1) << (note & 63));
+    
+    if (currentPattern == RANDOM) {
+        auto end = std::remove(patternNotes.begin(), patternNotes.begin() + patternLength, static_cast<juce::uint8>(note));
+        patternLength = static_cast<int>(end - patternNotes.begin());
+        if (currentStep >= patternLength) {
+            currentStep = -1;
+        }
+        return;
+    }
+    
+    buildPatternNotes();
 }
 
 void Arpeggiator::buildPatternNotes()
 {
-    currentPatternNotes.clear();
-    for (int note : heldNotes) {
-        currentPatternNotes.add(note);
+    // Held notes in ascending order, straight from the bitset
+    int numHeld = 0;
+    for (size_t word = 0; word < heldNotes.size(); ++word) {
+        for (auto bits = heldNotes[word]; bits != 0; bits &= bits - 1) {
+            const int lowestBit = juce::countNumberOfBits((bits & (~bits + 1)) - 1);
+            patternNotes[static_cast<size_t>(numHeld++)] = static_cast<juce::uint8>(static_cast<int>(word) * 64 + lowestBit);
+        }
     }
+    patternLength = numHeld;
     
-    // Sort based on pattern
+    // Arrange in playing order
     switch (currentPattern) {
-        case UP:
-            currentPatternNotes.sort();
-            break;
         case DOWN:
-            currentPatternNotes.sort();
-            for (int i = 0; i < currentPatternNotes.size() / 2; ++i) {
-                currentPatternNotes.swap(i, currentPatternNotes.size() - 1 - i);
-            }
+            std::reverse(patternNotes.begin(), patternNotes.begin() + patternLength);
             break;
         case UP_DOWN:
-            currentPatternNotes.sort();
-            for (int i = currentPatternNotes.size() - 2; i > 0; --i) {
-                currentPatternNotes.add(currentPatternNotes[i]);
+            // Up, then back down without repeating the top and bottom notes
+            for (int i = numHeld - 2; i > 0; --i) {
+                patternNotes[static_cast<size_t>(patternLength++)] = patternNotes[static_cast<size_t>(i)];
             }
             break;
         case RANDOM:
-            juce::Random random;
-            for (int i = currentPatternNotes.size() - 1; i > 0; --i) {
-                currentPatternNotes.swap(i, random.nextInt(i + 1));
+            for (int i = patternLength - 1; i > 0; --i) {
+                std::swap(patternNotes[static_cast<size_t>(i)], patternNotes[static_cast<size_t>(random.nextInt(i + 1))]);
             }
             break;
         default:
             break;
     }
+    
+    if (currentStep >= patternLength) {
+        currentStep = -1;
+    }
 }
 
 int Arpeggiator::getNextNote()
 {
-    int nextStep = currentStep;
-    
-    switch (currentPattern) {
-        case UP:
-            nextStep = (currentStep + 1) % currentPatternNotes.size();
-            if (nextStep == 0) {
-                currentOctave = (currentOctave + 1) % numOctaves;
-            }
-            break;
-        case DOWN:
-            nextStep = (currentStep - 1 + currentPatternNotes.size()) % currentPatternNotes.size();
-            if (nextStep == currentPatternNotes.size() - 1) {
-                currentOctave = (currentOctave - 1 + numOctaves) % numOctaves;
-            }
-            break;
-        case UP_DOWN:
-            if (ascending) {
-                nextStep++;
-                if (nextStep >= currentPatternNotes.size()) {
-                    nextStep = currentPatternNotes.size() - 2;
-                    ascending = false;
-                }
-            } else {
-                nextStep--;
-                if (nextStep < 0) {
-                    nextStep = 1;
-                    ascending = true;
-                }
-            }
-            break;
-        case RANDOM:
-            juce::Random random;
-            nextStep = random.nextInt(currentPatternNotes.size());
-            break;
-        default:
-            break;
+    // The pattern is already in playing order (for Random a shuffle that keeps its
+    // order as notes come and go), so every mode walks it forwards and moves through
+    // the octaves each time round
+    int nextStep = currentStep + 1;
+    if (nextStep >= patternLength) {
+        nextStep = 0;
+        if (currentStep >= 0) {
+            currentOctave = currentPattern == DOWN ? (currentOctave - 1 + numOctaves) % numOctaves
+                                                   : (currentOctave + 1) % numOctaves;
+        }
     }
-    
     return nextStep;
 }
 
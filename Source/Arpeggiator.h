@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FastRandom.h"
+#include "StepClock.h"
 
 class Arpeggiator
 {
@@ -13,47 +15,86 @@ public:
         PATTERN_COUNT
     };
     
+    // Step lengths, with dotted (D) and triplet (T) variants
+    enum Division {
+        QUARTER = 0, QUARTER_DOTTED, QUARTER_TRIPLET,
+        EIGHTH, EIGHTH_DOTTED, EIGHTH_TRIPLET,
+        SIXTEENTH, SIXTEENTH_DOTTED, SIXTEENTH_TRIPLET,
+        THIRTY_SECOND, THIRTY_SECOND_DOTTED, THIRTY_SECOND_TRIPLET,
+        DIVISION_COUNT
+    };
+    
+    static double getDivisionBeats(Division division); // In quarter notes
+    static juce::StringArray getDivisionNames();
+    
     Arpeggiator();
     
     void prepare(double sampleRate);
+    
+    // Adds the notes it plays to outputBuffer. While enabled it takes the incoming
+    // notes out of midiMessages and leaves everything else; while disabled it leaves
+    // midiMessages alone.
     void process(juce::MidiBuffer& midiMessages, juce::MidiBuffer& outputBuffer, int numSamples);
     
     void setEnabled(bool enabled) { isEnabled = enabled; }
-    void setPattern(Pattern pattern) { currentPattern = pattern; }
-    void setRate(float rateHz) { rate = rateHz; calculateStepSamples(); }
+    void setPattern(Pattern pattern);
+    void setRate(float rateHz) { rate = juce::jlimit(0.1f, 50.0f, rateHz); } // Steps per second when not synced
     void setSyncToHost(bool sync) { syncToHost = sync; }
+    void setDivision(Division newDivision) { division = newDivision; }
+    void setSwing(float amount) { swing = juce::jlimit(0.0f, 1.0f, amount); } // 1 delays every other step by a third
     void setOctaves(int octaves) { numOctaves = juce::jlimit(1, 4, octaves); }
-    void setGate(float gatePercent) { gate = gatePercent; }
+    void setGate(float gateFraction) { gate = juce::jlimit(0.05f, 1.0f, gateFraction); } // Of the step, 1 ties into the next
     
-    void setHostInfo(double bpm, bool isPlaying);
+    // Call once per block before process(). While the host plays, steps are locked to
+    // its PPQ position; otherwise an internal clock carries on from where it left off.
+    void setTransportPosition(double bpm, double ppqPosition, bool isPlaying);
     
 private:
     bool isEnabled = false;
     Pattern currentPattern = UP;
     float rate = 2.0f; // Hz
     bool syncToHost = false;
+    Division division = SIXTEENTH;
+    float swing = 0.0f;
     int numOctaves = 1;
     float gate = 0.8f;
     
     double sampleRate = 44100.0;
-    int samplesPerStep = 0;
-    int currentSample = 0;
-    int currentStep = 0;
+    int currentStep = -1;
     int currentOctave = 0;
-    bool ascending = true;
     
     double hostBPM = 120.0;
+    double hostPPQ = 0.0;
     bool hostIsPlaying = false;
     
-    juce::SortedSet<int> heldNotes;
-    juce::Array<int> currentPatternNotes;
+    StepClock stepClock;
+    double expectedPosition = 0.0; // Where the next block should start; anything else is a jump
+    juce::MidiBuffer passThrough; // What process() leaves in midiMessages
+    
+    // The sounding note and where (on the step clock) its gate closes
+    int playingNote = -1;
+    double playingNoteOff = 0.0;
+    
+    double getStepBeats() const;
+    void advanceStep(juce::MidiBuffer& buffer, int sampleOffset, double noteOffPosition);
+    
+    // Held notes as a 128-bit set plus their velocities, and the pattern built from
+    // them in a fixed buffer (Up/Down needs 2 * 128 - 2 steps). No heap use.
+    static constexpr int maxPatternLength = 256;
+    std::array<juce::uint64, 2> heldNotes {};
+    std::array<juce::uint8, 128> heldVelocities {};
+    std::array<juce::uint8, maxPatternLength> patternNotes {};
+    int patternLength = 0;
+    FastRandom random; // Fixed seed, so the Random pattern repeats between renders
     
-    void calculateStepSamples();
+    bool isHeld(int note) const noexcept { return (heldNotes[static_cast<size_t>(note >> 6)] >> (note & 63)) & 1; }
+    int getNumHeldNotes() const noexcept;
+    void addHeldNote(int note, int velocity);
+    void removeHeldNote(int note);
     void buildPatternNotes();
     int getNextNote();
     void noteOn(juce::MidiBuffer& buffer, int noteNumber, int velocity, int sampleOffset);
     void noteOff(juce::MidiBuffer& buffer, int noteNumber, int sampleOffset);
-    void allNotesOff(juce::MidiBuffer& buffer, int sampleOffset);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Arpeggiator)
 };
\ No newline at end of file
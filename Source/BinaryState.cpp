@@ -0,0 +1,114 @@
+#include "BinaryState.h"
+
+bool BinaryState::isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr && sizeInBytes >= 12
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+void BinaryState::write(const juce::Array<juce::RangedAudioParameter*>& parameters, juce::MemoryBlock& destData,
+                        const std::vector<Chunk>& chunks)
+{
+    destData.setSize(static_cast<size_t>(16 + parameters.size() * 8));
+    juce::MemoryOutputStream out(destData, false);
+    
+    out.writeInt(static_cast<int>(magic));
+    out.writeInt(currentVersion);
+    out.writeInt(parameters.size());
+    
+    for (auto* parameter : parameters) {
+        out.writeInt(static_cast<int>(hashParameterID(parameter->getParameterID())));
+        out.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+    }
+    
+    out.writeInt(static_cast<int>(chunks.size()));
+    for (const auto& chunk : chunks) {
+        out.writeInt(static_cast<int>(chunk.tag));
+        out.writeInt(static_cast<int>(chunk.data.getSize()));
+        out.write(chunk.data.getData(), chunk.data.getSize());
+    }
+    
+    out.flush();
+    destData.setSize(out.getDataSize());
+}
+
+bool BinaryState::read(const void* data, int sizeInBytes,
+                       const juce::Array<juce::RangedAudioParameter*>& parameters,
+                       std::vector<float>& normalisedValues,
+                       std::vector<Chunk>* chunks)
+{
+    if (!isBinaryState(data, sizeInBytes)) {
+        return false;
+    }
+    
+    juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+    in.readInt(); // Magic
+    
+    const int version = in.readInt();
+    const int numStored = in.readInt();
+    if (version < 1 || numStored < 0 || in.getNumBytesRemaining() < static_cast<juce::int64>(numStored) * 8 + 4) {
+        return false;
+    }
+    
+    normalisedValues.resize(static_cast<size_t>(parameters.size()));
+    for (int i = 0; i < parameters.size(); ++i) {
+        normalisedValues[static_cast<size_t>(i)] = parameters.getUnchecked(i)->getDefaultValue();
+    }
+    
+    // Parameters are usually stored in the same order they're declared in, so try the
+    // next index first and only search when the order differs
+    int nextIndex = 0;
+    for (int i = 0; i < numStored; ++i) {
+        const auto hash = static_cast<juce::uint32>(in.readInt());
+        const float value = in.readFloat();
+        
+        int index = -1;
+        for (int probe = 0; probe < parameters.size(); ++probe) {
+            const int candidate = (nextIndex + probe) % parameters.size();
+            if (hashParameterID(parameters.getUnchecked(candidate)->getParameterID()) == hash) {
+                index = candidate;
+                break;
+            }
+        }
+        
+        if (index >= 0) {
+            normalisedValues[static_cast<size_t>(index)] = parameters.getUnchecked(index)->convertTo0to1(value);
+            nextIndex = index + 1;
+        }
+    }
+    
+    // The caller picks out the tags it knows, so chunks from newer versions are ignored
+    if (chunks != nullptr) {
+        chunks->clear();
+    }
+    
+    const int numChunks = in.readInt();
+    for (int i = 0; i < numChunks && !in.isExhausted(); ++i) {
+        const auto tag = static_cast<juce::uint32>(in.readInt());
+        const int size = in.readInt();
+        if (size < 0 || in.getNumBytesRemaining() < size) {
+            return false;
+        }
+        
+        if (chunks != nullptr) {
+            Chunk chunk;
+            chunk.tag = tag;
+            in.readIntoMemoryBlock(chunk.data, size);
+            chunks->push_back(std::move(chunk));
+        } else {
+            in.setPosition(in.getPosition() + size);
+        }
+    }
+    
+    return true;
+}
+
+juce::uint32 BinaryState::hashParameterID(const juce::String& parameterID)
+{
+    // FNV-1a, 32 bit
+    juce::uint32 hash = 2166136261u;
+    for (auto p = parameterID.toRawUTF8(); *p != 0; ++p) {
+        hash = (hash ^ static_cast<juce::uint8>(*p)) * 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Compact plugin state: a versioned header, then one (parameter ID hash, plain value)
+// pair per parameter, then tagged chunks for anything that isn't a parameter.
+//
+//   int32  magic ("S37B")
+//   int32  version
+//   int32  number of parameters, then per parameter: uint32 ID hash, float value
+//   int32  number of chunks, then per chunk: uint32 tag, int32 size, size bytes
+//
+// Values are stored in plain (not normalised) units so a changed parameter range
+// still restores the same setting. Parameters missing from the state get their
+// defaults, unknown hashes and chunk tags are skipped, so older and newer versions can
+// read each other's states. All little-endian.
+class BinaryState
+{
+public:
+    static constexpr int currentVersion = 1;
+
+    struct Chunk
+    {
+        juce::uint32 tag = 0;
+        juce::MemoryBlock data;
+    };
+
+    static bool isBinaryState(const void* data, int sizeInBytes);
+
+    static void write(const juce::Array<juce::RangedAudioParameter*>& parameters, juce::MemoryBlock& destData,
+                      const std::vector<Chunk>& chunks = {});
+
+    // Fills normalisedValues in parameters order, and chunks (if given) with every
+    // chunk in the state. Returns false if the data is truncated or isn't a binary state.
+    static bool read(const void* data, int sizeInBytes,
+                     const juce::Array<juce::RangedAudioParameter*>& parameters,
+                     std::vector<float>& normalisedValues,
+                     std::vector<Chunk>* chunks = nullptr);
+
+    static juce::uint32 hashParameterID(const juce::String& parameterID);
+
+private:
+    static constexpr juce::uint32 magic = 0x42373353; // "S37B"
+
+    BinaryState() = delete;
+};
@@ -3,116 +3,88 @@
 
 Chorus::Chorus()
 {
-    lfo.initialise([](float x) { return std::sin(x); });
 }
 
 void Chorus::prepare(double newSampleRate, int samplesPerBlock)
 {
+    juce::ignoreUnused(samplesPerBlock);
     sampleRate = newSampleRate;
-    lfo.prepare({ newSampleRate, static_cast<juce::uint32>(samplesPerBlock), 1 });
-    lfo.setFrequency(0.5f); // Default rate
 
-    // Initialize delay buffers for each voice
+    // One delay line per channel, shared by the voices' taps
     const int delayBufferSize = static_cast<int>(sampleRate * 0.05); // 50ms max delay
-    for (auto& voice : voices)
+    delayBuffer.setSize(2, delayBufferSize);
+    delayBuffer.clear();
+
+    for (auto& state : channelStates)
     {
-        voice.buffer.setSize(2, delayBufferSize);
-        voice.buffer.clear();
-        voice.writePosition = 0;
-        voice.lfoPhase = 0.0f;
+        state.writePosition = 0;
+        state.lfoPhase = 0.0f;
     }
 }
 
 void Chorus::process(juce::AudioBuffer<float>& buffer)
 {
-    if (!isEnabled)
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        processChannel(buffer, channel);
+}
+
+void Chorus::processChannel(juce::AudioBuffer<float>& buffer, int channel)
+{
+    if (!isEnabled || channel >= delayBuffer.getNumChannels())
         return;
 
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    const int bufferSize = delayBuffer.getNumSamples();
+    auto* channelData = buffer.getWritePointer(channel);
+    auto* delayData = delayBuffer.getWritePointer(channel);
+    auto& state = channelStates[static_cast<size_t>(channel)];
 
-    // Create dry/wet mix
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
+    const float phaseIncrement = static_cast<float>(rateHz / sampleRate);
+    const float baseDelay = 0.005f * static_cast<float>(sampleRate);             // 5ms base delay
+    const float maxModulation = depth * 0.01f * static_cast<float>(sampleRate);  // Up to 10ms modulation
 
-    buffer.clear();
+    // Apply stereo width (more effect on channel 1)
+    float channelMix = mix;
+    if (channel == 1)
+        channelMix = juce::jlimit(0.0f, 1.0f, mix * (1.0f + width));
 
-    // Process each chorus voice
-    for (size_t i = 0; i < voices.size(); ++i)
+    for (int sample = 0; sample < numSamples; ++sample)
     {
-        for (int channel = 0; channel < numChannels; ++channel)
+        const float dry = channelData[sample];
+        delayData[state.writePosition] = dry;
+
+        float wet = 0.0f;
+        for (int voice = 0; voice < numVoices; ++voice)
         {
-            auto* channelData = dryBuffer.getReadPointer(channel);
-            auto* outputData = buffer.getWritePointer(channel);
+            float phase = state.lfoPhase + static_cast<float>(voice) / static_cast<float>(numVoices);
+            if (phase >= 1.0f)
+                phase -= 1.0f;
 
-            processVoice(voices[i], const_cast<float*>(channelData), numSamples, channel);
+            // Calculate LFO modulated delay time
+            const float lfoValue = 0.5f + 0.5f * std::sin(juce::MathConstants<float>::twoPi * phase);
+            const float delayTimeSamples = baseDelay + lfoValue * maxModulation;
 
-            // Mix this voice into the output
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                outputData[sample] += voices[i].buffer.getSample(channel, 
-                    (voices[i].writePosition + sample) % voices[i].buffer.getNumSamples());
-            }
-        }
-    }
+            // Calculate read position with interpolation
+            float readPos = static_cast<float>(state.writePosition) - delayTimeSamples;
+            if (readPos < 0.0f)
+                readPos += static_cast<float>(bufferSize);
 
-    // Apply mix and width
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        auto* dryData = dryBuffer.getReadPointer(channel);
-        auto* wetData = buffer.getWritePointer(channel);
+            const int readPosInt = static_cast<int>(readPos);
+            const float frac = readPos - static_cast<float>(readPosInt);
 
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float wet = wetData[sample] / static_cast<float>(voices.size());
-            float dry = dryData[sample];
-            
-            // Apply stereo width (more effect on channel 1)
-            float channelMix = mix;
-            if (channel == 1)
-                channelMix = juce::jlimit(0.0f, 1.0f, mix * (1.0f + width));
-            
-            wetData[sample] = dry * (1.0f - channelMix) + wet * channelMix;
+            // Linear interpolation
+            const float sample1 = delayData[readPosInt % bufferSize];
+            const float sample2 = delayData[(readPosInt + 1) % bufferSize];
+            wet += sample1 + frac * (sample2 - sample1);
         }
-    }
-}
 
-void Chorus::processVoice(Voice& voice, float* channelData, int numSamples, int channel)
-{
-    const int bufferSize = voice.buffer.getNumSamples();
-    auto* delayData = voice.buffer.getWritePointer(channel);
-    
-    // LFO parameters for this voice
-    const float lfoPhaseOffset = static_cast<float>(voices.data() - &voice) / static_cast<float>(voices.size());
-    const float baseDelay = 0.005f; // 5ms base delay
-    const float maxModulation = depth * 0.01f; // Up to 10ms modulation
+        wet /= static_cast<float>(numVoices);
+        channelData[sample] = dry * (1.0f - channelMix) + wet * channelMix;
 
-    for (int sample = 0; sample < numSamples; ++sample)
-    {
-        // Calculate LFO modulated delay time
-        float lfoValue = lfo.processSample(0.0f);
-        float delayTimeSamples = (baseDelay + lfoValue * maxModulation) * static_cast<float>(sampleRate);
-        
-        // Calculate read position with interpolation
-        float readPos = voice.writePosition - delayTimeSamples;
-        while (readPos < 0.0f)
-            readPos += bufferSize;
-        
-        int readPosInt = static_cast<int>(readPos);
-        float frac = readPos - readPosInt;
-        
-        // Linear interpolation
-        float sample1 = delayData[readPosInt % bufferSize];
-        float sample2 = delayData[(readPosInt + 1) % bufferSize];
-        float delayedSample = sample1 + frac * (sample2 - sample1);
-        
-        // Write input to delay buffer
-        delayData[voice.writePosition] = channelData[sample];
-        
-        // Store processed output
-        delayData[voice.writePosition] = delayedSample;
-        
-        // Advance write position
-        voice.writePosition = (voice.writePosition + 1) % bufferSize;
+        // Advance write position and LFO
+        state.writePosition = (state.writePosition + 1) % bufferSize;
+        state.lfoPhase += phaseIncrement;
+        if (state.lfoPhase >= 1.0f)
+            state.lfoPhase -= 1.0f;
     }
 }
@@ -9,31 +9,33 @@ public:
     
     void prepare(double sampleRate, int samplesPerBlock);
     void process(juce::AudioBuffer<float>& buffer);
+    void processChannel(juce::AudioBuffer<float>& buffer, int channel); // Channels are independent
     
     void setEnabled(bool enabled) { isEnabled = enabled; }
-    void setRate(float rateHz) { lfo.setFrequency(rateHz); }
+    void setRate(float rateHz) { this->rateHz = juce::jlimit(0.01f, 20.0f, rateHz); }
     void setDepth(float depth) { this->depth = juce::jlimit(0.0f, 1.0f, depth); }
     void setMix(float mix) { this->mix = juce::jlimit(0.0f, 1.0f, mix); }
     void setWidth(float width) { this->width = juce::jlimit(0.0f, 1.0f, width); }
     
 private:
+    static constexpr int numVoices = 3; // 3 voice chorus, taps spread evenly around the LFO cycle
+    
     bool isEnabled = false;
+    float rateHz = 0.5f;
     float depth = 0.5f;
     float mix = 0.5f;
     float width = 0.5f;
     
     double sampleRate = 44100.0;
     
-    struct Voice {
-        juce::AudioBuffer<float> buffer;
+    // Everything a channel touches is its own, so channels can run on different threads
+    struct ChannelState {
         int writePosition = 0;
         float lfoPhase = 0.0f;
     };
     
-    std::array<Voice, 3> voices; // 3 voice chorus
-    juce::dsp::Oscillator<float> lfo;
-    
-    void processVoice(Voice& voice, float* channelData, int numSamples, int channel);
+    juce::AudioBuffer<float> delayBuffer;
+    std::array<ChannelState, 2> channelStates;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Chorus)
-};
\ No newline at end of file
+};
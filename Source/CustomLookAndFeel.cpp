@@ -33,6 +33,7 @@ CustomLookAndFeel::~CustomLookAndFeel()
 bool CustomLookAndFeel::loadKnobGraphics(const void* data, size_t size)
 {
     knobStrip = juce::ImageCache::getFromMemory(data, size);
+    knobStripSource = data;
     if (knobStrip.isValid()) {
         frameWidth = knobStrip.getWidth() / numFrames;
         frameHeight = knobStrip.getHeight();
@@ -51,22 +52,41 @@ void CustomLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int wi
                                         float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
                                         juce::Slider& slider)
 {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    int frameIndex = 0;
     if (knobStrip.isValid() && frameWidth > 0) {
         // Calculate frame index based on slider position (0-127)
         const bool isMouseOver = slider.isMouseOverOrDragging();
         const int baseFrame = isMouseOver ? 64 : 0; // Hover states start at frame 64
-        const int frameIndex = baseFrame + juce::jlimit(0, 63, static_cast<int>(sliderPos * 63));
-
-        // Ensure we don't go out of bounds
-        const int safeFrameIndex = juce::jlimit(0, numFrames - 1, frameIndex);
-
-        // Draw the appropriate frame from the sprite sheet
-        g.drawImage(knobStrip, x, y, width, height,
-                   safeFrameIndex * frameWidth, 0, frameWidth, frameHeight);
+        frameIndex = juce::jlimit(0, numFrames - 1, baseFrame + juce::jlimit(0, 63, static_cast<int>(sliderPos * 63)));
     } else {
-        // Fallback: draw custom rotary slider
-        drawFallbackRotarySlider(g, x, y, width, height, sliderPos, slider);
+        frameIndex = juce::jlimit(0, numVectorFrames - 1, juce::roundToInt(sliderPos * (numVectorFrames - 1)));
     }
+
+    // Blit the cached frame at its native resolution
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobFrame(frameIndex, width, height, scale, slider),
+                juce::Rectangle<int>(x, y, width, height).toFloat(), juce::RectanglePlacement::stretchToFit);
+}
+
+const juce::Image& CustomLookAndFeel::getKnobFrame(int frameIndex, int width, int height, float scale, juce::Slider& slider)
+{
+    const bool useStrip = knobStrip.isValid() && frameWidth > 0;
+
+    return knobCache->getFrame(useStrip ? knobStripSource : nullptr, useStrip ? numFrames : numVectorFrames,
+                               frameIndex, width, height, scale, [&](juce::Graphics& frameGraphics) {
+        if (useStrip) {
+            frameGraphics.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+            frameGraphics.drawImage(knobStrip, 0, 0, width, height,
+                                    frameIndex * frameWidth, 0, frameWidth, frameHeight);
+        } else {
+            drawFallbackRotarySlider(frameGraphics, 0, 0, width, height,
+                                     frameIndex / static_cast<float>(numVectorFrames - 1), slider);
+        }
+    });
 }
 
 void CustomLookAndFeel::drawFallbackRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "KnobImageCache.h"
 
 class CustomLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -42,6 +43,7 @@ public:
 
 private:
     juce::Image knobStrip;
+    const void* knobStripSource = nullptr; // Identifies the strip's frames in the knob cache
     juce::Image backgroundImage;
 
     int numFrames = 128; // 64 positions + 64 hover states
@@ -55,5 +57,12 @@ private:
     void drawFallbackRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                                  float sliderPos, juce::Slider& slider);
 
+    // Knob frames rendered once per knob size in physical pixels (so per display
+    // scale too) and shared with every other editor. A repaint then only blits.
+    static constexpr int numVectorFrames = 64;
+    juce::SharedResourcePointer<KnobImageCache> knobCache;
+
+    const juce::Image& getKnobFrame(int frameIndex, int width, int height, float scale, juce::Slider& slider);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CustomLookAndFeel)
 };
@@ -15,6 +15,7 @@ void CustomSlider::setKnobImage(const juce::Image& image, int numFrames)
 {
     knobImage = image;
     frameCount = numFrames;
+    cachedFrameIndex = -1;
     if (knobImage.isValid()) {
         frameWidth = knobImage.getWidth() / frameCount;
         frameHeight = knobImage.getHeight();
@@ -43,8 +44,21 @@ void CustomSlider::drawCustomKnob(juce::Graphics& g)
     
     const int frameIndex = baseFrame + valueFrame;
     
-    g.drawImage(knobImage, 0, 0, getWidth(), getHeight(),
-               frameIndex * frameWidth, 0, frameWidth, frameHeight);
+    // Rescale the filmstrip frame only when the frame, size or display scale changes
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int pixelWidth = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+    const int pixelHeight = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+    
+    if (frameIndex != cachedFrameIndex || cachedFrame.getWidth() != pixelWidth || cachedFrame.getHeight() != pixelHeight) {
+        cachedFrame = juce::Image(juce::Image::ARGB, pixelWidth, pixelHeight, true);
+        juce::Graphics frameGraphics(cachedFrame);
+        frameGraphics.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+        frameGraphics.drawImage(knobImage, 0, 0, pixelWidth, pixelHeight,
+                                frameIndex * frameWidth, 0, frameWidth, frameHeight);
+        cachedFrameIndex = frameIndex;
+    }
+    
+    g.drawImage(cachedFrame, getLocalBounds().toFloat(), juce::RectanglePlacement::stretchToFit);
 }
 
 void CustomSlider::mouseEnter(const juce::MouseEvent&)
@@ -21,6 +21,10 @@ private:
     int frameHeight = 0;
     bool isHovered = false;
     
+    // The last frame drawn, scaled to the knob's size in physical pixels
+    juce::Image cachedFrame;
+    int cachedFrameIndex = -1;
+    
     void drawCustomKnob(juce::Graphics& g);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CustomSlider)
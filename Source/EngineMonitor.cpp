@@ -0,0 +1,110 @@
+// EngineMonitor.cpp
+#include "EngineMonitor.h"
+
+EngineMonitor::EngineMonitor(Telemetry& t)
+    : telemetry(t)
+{
+    samples.resize(static_cast<size_t>(Telemetry::sampleCapacity));
+    setInterceptsMouseClicks(false, false);
+
+    telemetry.attachConsumer();
+    startTimerHz(30);
+}
+
+EngineMonitor::~EngineMonitor()
+{
+    stopTimer();
+    telemetry.detachConsumer();
+}
+
+void EngineMonitor::timerCallback()
+{
+    const bool hasBlock = telemetry.readLatestBlockInfo(blockInfo);
+    const int numSamples = telemetry.readSamples(samples.data(), static_cast<int>(samples.size()));
+    if (!hasBlock && numSamples == 0)
+        return;
+
+    if (numSamples > 0)
+    {
+        double sumOfSquares = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            sumOfSquares += samples[static_cast<size_t>(i)] * samples[static_cast<size_t>(i)];
+        outputRms = static_cast<float>(std::sqrt(sumOfSquares / numSamples));
+    }
+
+    if (hasBlock)
+        cpuLoad += 0.3f * (blockInfo.cpuLoad - cpuLoad);
+
+    if (onTelemetry)
+        onTelemetry(samples.data(), numSamples, telemetry.getReadPosition(), hasBlock ? &blockInfo : nullptr);
+
+    repaint();
+}
+
+void EngineMonitor::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xff2c3e50).darker(0.3f));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    auto area = bounds.reduced(4.0f);
+    const auto accent = juce::Colour(0xfff39c12);
+
+    // Voices: one bar each, height is the amp envelope
+    auto voiceArea = area.removeFromLeft(area.getWidth() * 0.4f);
+    const int numVoices = juce::jmax(1, blockInfo.numVoices);
+    const float barWidth = voiceArea.getWidth() / static_cast<float>(numVoices);
+    int loudestVoice = -1;
+
+    for (int i = 0; i < blockInfo.numVoices; ++i)
+    {
+        const auto& voice = blockInfo.voices[static_cast<size_t>(i)];
+        auto bar = juce::Rectangle<float>(voiceArea.getX() + i * barWidth, voiceArea.getY(), barWidth, voiceArea.getHeight()).reduced(1.0f, 0.0f);
+        g.setColour(juce::Colours::black.withAlpha(0.3f));
+        g.fillRect(bar);
+
+        if (voice.note >= 0)
+        {
+            g.setColour(accent);
+            g.fillRect(bar.removeFromBottom(bar.getHeight() * juce::jlimit(0.0f, 1.0f, voice.level)));
+
+            if (loudestVoice < 0 || voice.level > blockInfo.voices[static_cast<size_t>(loudestVoice)].level)
+                loudestVoice = i;
+        }
+    }
+
+    // LFOs of the loudest voice, as bipolar bars around the centre line
+    area.removeFromLeft(6.0f);
+    auto lfoArea = area.removeFromLeft(area.getWidth() * 0.35f);
+    for (int lfo = 0; lfo < 2; ++lfo)
+    {
+        auto row = lfoArea.removeFromTop(lfoArea.getHeight() / static_cast<float>(2 - lfo)).reduced(0.0f, 2.0f);
+        g.setColour(juce::Colours::black.withAlpha(0.3f));
+        g.fillRect(row);
+
+        if (loudestVoice >= 0)
+        {
+            const auto& voice = blockInfo.voices[static_cast<size_t>(loudestVoice)];
+            const float value = juce::jlimit(-1.0f, 1.0f, lfo == 0 ? voice.lfo1 : voice.lfo2);
+            const float centre = row.getCentreX();
+            const float end = centre + value * row.getWidth() * 0.5f;
+            g.setColour(juce::Colour(0xffecf0f1));
+            g.fillRect(juce::Rectangle<float>(juce::jmin(centre, end), row.getY(), std::abs(end - centre), row.getHeight()));
+        }
+    }
+
+    // Output RMS with the block peak as a tick, then CPU load
+    area.removeFromLeft(6.0f);
+    auto meter = area.removeFromTop(area.getHeight() * 0.45f);
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.fillRect(meter);
+    g.setColour(accent);
+    g.fillRect(meter.withWidth(meter.getWidth() * juce::jlimit(0.0f, 1.0f, outputRms)));
+    const float peak = juce::jlimit(0.0f, 1.0f, juce::jmax(blockInfo.outputPeaks[0], blockInfo.outputPeaks[1]));
+    g.setColour(peak >= 1.0f ? juce::Colours::red : juce::Colour(0xffecf0f1));
+    g.fillRect(meter.getX() + meter.getWidth() * peak - 1.0f, meter.getY(), 2.0f, meter.getHeight());
+
+    g.setColour(juce::Colour(0xffecf0f1));
+    g.setFont(11.0f);
+    g.drawText("CPU " + juce::String(cpuLoad * 100.0f, 1) + "%", area, juce::Justification::centredLeft, false);
+}
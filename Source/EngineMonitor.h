@@ -0,0 +1,33 @@
+// EngineMonitor.h
+#pragma once
+
+#include <JuceHeader.h>
+#include "Telemetry.h"
+
+// Status strip for the editor: one bar per voice (amp envelope), the LFOs of the
+// loudest voice, the output level and CPU load. It's the editor's Telemetry consumer,
+// attached for as long as it exists, and reads the engine's FIFOs at 30 Hz.
+class EngineMonitor : public juce::Component, private juce::Timer
+{
+public:
+    explicit EngineMonitor(Telemetry& telemetry);
+    ~EngineMonitor() override;
+
+    void paint(juce::Graphics&) override;
+
+    // Called from the timer with each tick's samples, so other views can share the
+    // stream. endPosition is the stream position just after the last sample;
+    // newBlockInfo is null when no block arrived this tick.
+    std::function<void(const float* samples, int numSamples, juce::int64 endPosition, const Telemetry::BlockInfo* newBlockInfo)> onTelemetry;
+
+private:
+    Telemetry& telemetry;
+    Telemetry::BlockInfo blockInfo;
+    std::vector<float> samples; // Scratch for one tick's output samples, sized once
+    float outputRms = 0.0f;
+    float cpuLoad = 0.0f;       // Smoothed over a few ticks so the readout is legible
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineMonitor)
+};
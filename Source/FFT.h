@@ -0,0 +1,46 @@
+// FFT.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include <vector>
+
+namespace FFT
+{
+    // In-place iterative radix-2 FFT; the size must be a power of two
+    inline void transform(std::vector<std::complex<float>>& data)
+    {
+        const size_t n = data.size();
+        jassert(juce::isPowerOfTwo(n));
+
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+
+        for (size_t length = 2; length <= n; length <<= 1)
+        {
+            const float angle = -juce::MathConstants<float>::twoPi / static_cast<float>(length);
+            const std::complex<float> step(std::cos(angle), std::sin(angle));
+
+            for (size_t start = 0; start < n; start += length)
+            {
+                std::complex<float> twiddle(1.0f, 0.0f);
+                for (size_t k = 0; k < length / 2; ++k)
+                {
+                    const auto even = data[start + k];
+                    const auto odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= step;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// FastRandom.h
+#pragma once
+
+#include <JuceHeader.h>
+
+// Small seedable xorshift32 generator for the audio thread.
+// Unlike juce::Random it never seeds itself from the clock, so the same seed
+// always gives the same sequence and offline renders are bit-reproducible.
+// Four independent streams are kept side by side so fillBipolar() runs them
+// in lock-step and vectorises; the scalar calls use the first stream.
+class FastRandom {
+public:
+    static constexpr int numStreams = 4;
+
+    explicit FastRandom(juce::uint32 seed = 1) { setSeed(seed); }
+
+    void setSeed(juce::uint32 seed) {
+        for (int i = 0; i < numStreams; ++i) {
+            // xorshift must never hold zero
+            const juce::uint32 value = mix(seed + static_cast<juce::uint32>(i) * 0x9e3779b9u);
+            state[i] = value != 0 ? value : 0x6d2b79f5u;
+        }
+    }
+
+    // Combines e.g. a voice index, note number and stream id into one well-spread seed
+    static juce::uint32 makeSeed(juce::uint32 a, juce::uint32 b, juce::uint32 c = 0) {
+        return mix(a * 0x85ebca6bu ^ mix(b * 0xc2b2ae35u ^ mix(c + 0x27d4eb2fu)));
+    }
+
+    juce::uint32 nextUInt() { return step(state[0]); }
+
+    // 0 to 1 (exclusive), using the top 24 bits so every value is exact in a float
+    float nextFloat() { return static_cast<float>(nextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+    // -1 to +1
+    float nextBipolar() { return nextFloat() * 2.0f - 1.0f; }
+
+    int nextInt(int maxValue) {
+        jassert(maxValue > 0);
+        return static_cast<int>((static_cast<juce::uint64>(nextUInt()) * static_cast<juce::uint64>(maxValue)) >> 32);
+    }
+
+    // White noise fill, -1 to +1
+    void fillBipolar(float* dest, int numSamples) {
+        int i = 0;
+        for (; i + numStreams <= numSamples; i += numStreams) {
+            for (int s = 0; s < numStreams; ++s) {
+                dest[i + s] = static_cast<float>(step(state[s]) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+            }
+        }
+        for (; i < numSamples; ++i) {
+            dest[i] = nextBipolar();
+        }
+    }
+
+private:
+    alignas(16) juce::uint32 state[numStreams];
+
+    static juce::uint32 step(juce::uint32& x) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    }
+
+    // Murmur3 finaliser, spreads nearby seeds across the whole range
+    static juce::uint32 mix(juce::uint32 h) {
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+};
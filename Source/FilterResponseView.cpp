@@ -0,0 +1,162 @@
+// FilterResponseView.cpp
+#include "FilterResponseView.h"
+#include "MoogFilter.h"
+
+FilterResponseView::FilterResponseView(juce::AudioProcessor& p, juce::AudioProcessorValueTreeState& state, RepaintThrottler& t)
+    : processor(p), throttler(t), worker(*this)
+{
+    cutoffValue = state.getRawParameterValue("filterCutoff");
+    resonanceValue = state.getRawParameterValue("filterResonance");
+    driveValue = state.getRawParameterValue("filterDrive");
+
+    setInterceptsMouseClicks(false, false);
+
+    worker.startThread();
+    throttler.addClient(this);
+}
+
+FilterResponseView::~FilterResponseView()
+{
+    throttler.removeClient(this);
+    worker.stopThread(2000);
+    cancelPendingUpdate();
+}
+
+void FilterResponseView::throttledUpdate()
+{
+    if (cutoffValue == nullptr || resonanceValue == nullptr || driveValue == nullptr)
+        return;
+
+    Request request;
+    request.cutoff = cutoffValue->load();
+    request.resonance = resonanceValue->load();
+    request.drive = driveValue->load();
+    request.sampleRate = processor.getSampleRate() > 0.0 ? processor.getSampleRate() : 44100.0;
+    request.width = getWidth();
+    request.height = getHeight();
+
+    if (request == lastRequest || request.width <= 0 || request.height <= 0)
+        return;
+
+    lastRequest = request;
+    worker.compute(request);
+}
+
+void FilterResponseView::buildPaths(const Request& request, juce::Path& curve, juce::Path& fill)
+{
+    curve.clear();
+    fill.clear();
+
+    MoogFilter filter;
+    filter.setSampleRate(static_cast<float>(request.sampleRate));
+    filter.setCutoff(request.cutoff);
+    filter.setResonance(request.resonance);
+    filter.setDrive(request.drive);
+
+    const float topFrequency = juce::jmin(maxFrequency, static_cast<float>(request.sampleRate * 0.5) * 0.99f);
+    const float logSpan = std::log(topFrequency / minFrequency);
+    const float height = static_cast<float>(request.height);
+
+    // Every other pixel is plenty for a curve this smooth
+    for (int x = 0; x <= request.width; x += 2)
+    {
+        const float frequency = minFrequency * std::exp(logSpan * x / request.width);
+        const float decibels = juce::Decibels::gainToDecibels(filter.getMagnitudeResponse(frequency), minDecibels);
+        const float y = juce::jmap(juce::jlimit(minDecibels, maxDecibels, decibels), maxDecibels, minDecibels, 0.0f, height);
+
+        if (x == 0)
+            curve.startNewSubPath(0.0f, y);
+        else
+            curve.lineTo(static_cast<float>(x), y);
+    }
+
+    fill = curve;
+    fill.lineTo(static_cast<float>(request.width), height);
+    fill.lineTo(0.0f, height);
+    fill.closeSubPath();
+}
+
+void FilterResponseView::handleAsyncUpdate()
+{
+    {
+        const juce::ScopedLock sl(resultLock);
+        if (!resultReady)
+            return;
+
+        std::swap(curve, readyCurve);
+        std::swap(fill, readyFill);
+        resultReady = false;
+    }
+
+    repaint();
+}
+
+void FilterResponseView::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xff2c3e50).darker(0.3f));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    // 0 dB
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.drawHorizontalLine(juce::roundToInt(juce::jmap(0.0f, maxDecibels, minDecibels, 0.0f, bounds.getHeight())), 0.0f, bounds.getWidth());
+
+    const auto accent = juce::Colour(0xfff39c12);
+    g.setColour(accent.withAlpha(0.25f));
+    g.fillPath(fill);
+    g.setColour(accent);
+    g.strokePath(curve, juce::PathStrokeType(1.5f));
+}
+
+//==============================================================================
+FilterResponseView::Worker::Worker(FilterResponseView& ownerToUse)
+    : juce::Thread("Filter response"), owner(ownerToUse)
+{
+}
+
+FilterResponseView::Worker::~Worker()
+{
+    stopThread(2000);
+}
+
+void FilterResponseView::Worker::compute(const Request& request)
+{
+    {
+        const juce::ScopedLock sl(requestLock);
+        requested = request;
+        hasRequest = true;
+    }
+    notify();
+}
+
+void FilterResponseView::Worker::run()
+{
+    juce::Path curve, fill;
+
+    while (!threadShouldExit())
+    {
+        Request request;
+        bool gotRequest = false;
+        {
+            const juce::ScopedLock sl(requestLock);
+            request = requested;
+            gotRequest = std::exchange(hasRequest, false);
+        }
+
+        if (!gotRequest)
+        {
+            wait(-1);
+            continue;
+        }
+
+        // A newer request while this one was computing simply replaces the result
+        buildPaths(request, curve, fill);
+        {
+            const juce::ScopedLock sl(owner.resultLock);
+            std::swap(owner.readyCurve, curve);
+            std::swap(owner.readyFill, fill);
+            owner.resultReady = true;
+        }
+        owner.triggerAsyncUpdate();
+    }
+}
@@ -0,0 +1,89 @@
+// FilterResponseView.h
+#pragma once
+
+#include <JuceHeader.h>
+#include "RepaintThrottler.h"
+
+// Magnitude response of the filter at the current cutoff, resonance and drive.
+// The throttler's tick checks the three parameters; only when one of them (or the
+// size, or the sample rate) has changed does it hand a request to the worker thread,
+// which evaluates MoogFilter::getMagnitudeResponse() and builds the paths. The
+// message thread swaps the finished paths in and strokes them, so dragging the
+// cutoff costs it no more than a repaint.
+class FilterResponseView : public juce::Component,
+                           public RepaintThrottler::Client,
+                           private juce::AsyncUpdater
+{
+public:
+    FilterResponseView(juce::AudioProcessor& processor, juce::AudioProcessorValueTreeState& state, RepaintThrottler& throttler);
+    ~FilterResponseView() override;
+
+    void throttledUpdate() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override { throttledUpdate(); }
+
+private:
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDecibels = -48.0f;
+    static constexpr float maxDecibels = 24.0f;
+
+    struct Request
+    {
+        float cutoff = 0.0f;
+        float resonance = 0.0f;
+        float drive = 0.0f;
+        double sampleRate = 0.0;
+        int width = 0;
+        int height = 0;
+
+        bool operator==(const Request& other) const
+        {
+            return cutoff == other.cutoff && resonance == other.resonance && drive == other.drive
+                && sampleRate == other.sampleRate && width == other.width && height == other.height;
+        }
+        bool operator!=(const Request& other) const { return !(*this == other); }
+    };
+
+    juce::AudioProcessor& processor;
+    RepaintThrottler& throttler;
+    std::atomic<float>* cutoffValue = nullptr;
+    std::atomic<float>* resonanceValue = nullptr;
+    std::atomic<float>* driveValue = nullptr;
+
+    Request lastRequest;
+    juce::Path curve;
+    juce::Path fill;
+
+    // Paths finished by the worker, waiting for the message thread
+    juce::CriticalSection resultLock;
+    juce::Path readyCurve;
+    juce::Path readyFill;
+    bool resultReady = false;
+
+    static void buildPaths(const Request& request, juce::Path& curve, juce::Path& fill);
+    void handleAsyncUpdate() override;
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(FilterResponseView& owner);
+        ~Worker() override;
+
+        void compute(const Request& request);
+        void run() override;
+
+    private:
+        FilterResponseView& owner;
+        juce::CriticalSection requestLock;
+        Request requested;
+        bool hasRequest = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+    };
+
+    Worker worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterResponseView)
+};
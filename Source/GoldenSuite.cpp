@@ -0,0 +1,300 @@
+// GoldenSuite.cpp
+#include "GoldenSuite.h"
+#include "FFT.h"
+#include <iostream>
+
+namespace
+{
+    juce::String toDecibelString(float gain)
+    {
+        return juce::Decibels::toString(juce::Decibels::gainToDecibels(gain, -200.0f), 1, -200.0f) + "FS";
+    }
+}
+
+GoldenSuite::Comparison GoldenSuite::compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference)
+{
+    Comparison comparison;
+
+    if (rendered.getNumChannels() != reference.getNumChannels())
+    {
+        comparison.result = juce::Result::fail("channel count " + juce::String(rendered.getNumChannels())
+                                               + ", reference has " + juce::String(reference.getNumChannels()));
+        return comparison;
+    }
+
+    if (rendered.getNumSamples() != reference.getNumSamples())
+    {
+        comparison.result = juce::Result::fail("length " + juce::String(rendered.getNumSamples())
+                                               + " samples, reference has " + juce::String(reference.getNumSamples()));
+        return comparison;
+    }
+
+    double sumSquares = 0.0;
+    for (int channel = 0; channel < rendered.getNumChannels(); ++channel)
+    {
+        const float* a = rendered.getReadPointer(channel);
+        const float* b = reference.getReadPointer(channel);
+
+        for (int i = 0; i < rendered.getNumSamples(); ++i)
+        {
+            const float error = a[i] - b[i];
+            comparison.maxAbsError = juce::jmax(comparison.maxAbsError, std::abs(error));
+            sumSquares += static_cast<double>(error) * error;
+        }
+    }
+
+    const auto totalSamples = static_cast<double>(rendered.getNumChannels()) * rendered.getNumSamples();
+    comparison.rmsError = totalSamples > 0.0 ? static_cast<float>(std::sqrt(sumSquares / totalSamples)) : 0.0f;
+
+    // Identical renders have identical spectra, skip the FFTs
+    if (comparison.maxAbsError > 0.0f)
+        comparison.spectralError = computeSpectralError(rendered, reference);
+
+    return comparison;
+}
+
+float GoldenSuite::computeSpectralError(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference)
+{
+    // Bins quieter than this in both renders are ignored, so differences in the noise
+    // floor of silent passages don't swamp the result
+    constexpr float floorDb = -100.0f;
+    constexpr int hopSize = fftSize / 2;
+
+    std::vector<float> window(fftSize);
+    float windowSum = 0.0f;
+    for (int i = 0; i < fftSize; ++i)
+    {
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / fftSize);
+        windowSum += window[static_cast<size_t>(i)];
+    }
+
+    // Scale so a full-scale sine reads 0 dB
+    const float magnitudeScale = 2.0f / windowSum;
+
+    std::vector<std::complex<float>> spectrumA(fftSize), spectrumB(fftSize);
+    double sumSquares = 0.0;
+    juce::int64 numBins = 0;
+
+    for (int channel = 0; channel < rendered.getNumChannels(); ++channel)
+    {
+        const float* a = rendered.getReadPointer(channel);
+        const float* b = reference.getReadPointer(channel);
+
+        for (int start = 0; start < rendered.getNumSamples(); start += hopSize)
+        {
+            for (int i = 0; i < fftSize; ++i)
+            {
+                const int index = start + i;
+                const bool inRange = index < rendered.getNumSamples();
+                const float w = window[static_cast<size_t>(i)];
+                spectrumA[static_cast<size_t>(i)] = inRange ? a[index] * w : 0.0f;
+                spectrumB[static_cast<size_t>(i)] = inRange ? b[index] * w : 0.0f;
+            }
+
+            FFT::transform(spectrumA);
+            FFT::transform(spectrumB);
+
+            for (int bin = 1; bin < fftSize / 2; ++bin)
+            {
+                const float dbA = juce::Decibels::gainToDecibels(std::abs(spectrumA[static_cast<size_t>(bin)]) * magnitudeScale, -200.0f);
+                const float dbB = juce::Decibels::gainToDecibels(std::abs(spectrumB[static_cast<size_t>(bin)]) * magnitudeScale, -200.0f);
+                if (dbA < floorDb && dbB < floorDb)
+                    continue;
+
+                const float difference = juce::jmax(dbA, floorDb) - juce::jmax(dbB, floorDb);
+                sumSquares += static_cast<double>(difference) * difference;
+                ++numBins;
+            }
+        }
+    }
+
+    return numBins > 0 ? static_cast<float>(std::sqrt(sumSquares / static_cast<double>(numBins))) : 0.0f;
+}
+
+juce::Result GoldenSuite::readAudioFile(const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader { formatManager.createReaderFor(file) };
+    if (reader == nullptr)
+        return juce::Result::fail("Couldn't read " + file.getFullPathName());
+
+    buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    return juce::Result::ok();
+}
+
+int GoldenSuite::runCommandLine(const juce::ArgumentList& args, OfflineRenderer::Settings settings)
+{
+    const auto suiteDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--suite").unquoted());
+    const auto referenceDirectory = suiteDirectory.getChildFile("reference");
+    const auto outputDirectory = args.containsOption("--out")
+        ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--out").unquoted())
+        : suiteDirectory.getChildFile("output");
+
+    const bool updateReference = args.containsOption("--update-reference");
+    const bool exact = args.containsOption("--exact");
+    const float tolerance = juce::Decibels::decibelsToGain(args.containsOption("--tolerance")
+                                                           ? args.getValueForOption("--tolerance").getFloatValue() : -80.0f);
+    const float spectralTolerance = args.containsOption("--spectral-tolerance")
+                                        ? args.getValueForOption("--spectral-tolerance").getFloatValue() : 0.5f;
+    const double maxSlowdown = args.containsOption("--max-slowdown")
+                                   ? args.getValueForOption("--max-slowdown").getDoubleValue() : 1.25;
+
+    // Float output, so the comparison sees exactly what the processor produced
+    settings.bitDepth = 32;
+
+    auto midiFiles = suiteDirectory.getChildFile("midi").findChildFiles(juce::File::findFiles, false, "*.mid;*.midi");
+    auto presetFiles = suiteDirectory.getChildFile("presets").findChildFiles(juce::File::findFiles, false, "*.xml");
+    midiFiles.sort();
+    presetFiles.sort();
+
+    if (midiFiles.isEmpty())
+    {
+        std::cerr << "No MIDI files in " << suiteDirectory.getChildFile("midi").getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (presetFiles.isEmpty())
+        presetFiles.add(juce::File()); // The default patch
+
+    if (outputDirectory.createDirectory().failed() || (updateReference && referenceDirectory.createDirectory().failed()))
+    {
+        std::cerr << "Couldn't create the output directories" << std::endl;
+        return 1;
+    }
+
+    juce::Array<OfflineRenderer::Job> jobs;
+    juce::StringArray caseNames;
+    for (const auto& presetFile : presetFiles)
+    {
+        for (const auto& midiFile : midiFiles)
+        {
+            const auto presetName = presetFile == juce::File() ? juce::String("default") : presetFile.getFileNameWithoutExtension();
+            const auto caseName = presetName + "__" + midiFile.getFileNameWithoutExtension();
+
+            OfflineRenderer::Job job;
+            job.midiFile = midiFile;
+            job.presetFile = presetFile;
+            job.outputFile = outputDirectory.getChildFile(caseName + ".wav");
+            jobs.add(job);
+            caseNames.add(caseName);
+        }
+    }
+
+    // One case at a time by default, so the timings aren't skewed by the other cases
+    const int numParallel = args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue() : 1;
+    const auto outcomes = OfflineRenderer(settings).renderBatch(jobs, numParallel);
+
+    const auto timingsFile = referenceDirectory.getChildFile("timings.txt");
+    juce::StringPairArray referenceTimings;
+    {
+        juce::StringArray lines;
+        timingsFile.readLines(lines);
+        for (const auto& line : lines)
+            if (line.containsChar('\t'))
+                referenceTimings.set(line.upToFirstOccurrenceOf("\t", false, false), line.fromFirstOccurrenceOf("\t", false, false));
+    }
+
+    int numFailed = 0;
+    int numSkipped = 0;
+    juce::String newTimings;
+
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        const auto& outcome = outcomes[static_cast<size_t>(i)];
+        const auto& caseName = caseNames[i];
+        const auto nsPerSample = outcome.getNanosecondsPerSample();
+
+        if (outcome.result.failed())
+        {
+            std::cout << "FAIL  " << caseName << ": " << outcome.result.getErrorMessage() << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        if (updateReference)
+        {
+            if (!jobs[i].outputFile.copyFileTo(referenceDirectory.getChildFile(caseName + ".wav")))
+            {
+                std::cout << "FAIL  " << caseName << ": couldn't update the reference" << std::endl;
+                ++numFailed;
+                continue;
+            }
+
+            newTimings << caseName << "\t" << juce::String(nsPerSample, 2) << "\n";
+            std::cout << "SAVED " << caseName << "  " << juce::String(nsPerSample, 1) << " ns/sample" << std::endl;
+            continue;
+        }
+
+        const auto referenceFile = referenceDirectory.getChildFile(caseName + ".wav");
+        if (!referenceFile.existsAsFile())
+        {
+            // Not a regression: there's nothing to compare with until references are recorded
+            std::cout << "SKIP  " << caseName << ": no reference render, record one with --update-reference" << std::endl;
+            ++numSkipped;
+            continue;
+        }
+
+        juce::AudioBuffer<float> rendered, reference;
+        auto result = readAudioFile(jobs[i].outputFile, rendered);
+        if (result.wasOk())
+            result = readAudioFile(referenceFile, reference);
+
+        Comparison comparison;
+        if (result.wasOk())
+        {
+            comparison = compare(rendered, reference);
+            result = comparison.result;
+        }
+
+        if (result.wasOk())
+        {
+            if (exact && comparison.maxAbsError > 0.0f)
+                result = juce::Result::fail("not bit-exact");
+            else if (!exact && comparison.maxAbsError > tolerance)
+                result = juce::Result::fail("max abs error above " + toDecibelString(tolerance));
+            else if (!exact && comparison.spectralError > spectralTolerance)
+                result = juce::Result::fail("spectral difference above " + juce::String(spectralTolerance, 2) + " dB");
+        }
+
+        juce::String timing = juce::String(nsPerSample, 1) + " ns/sample";
+        if (referenceTimings.containsKey(caseName))
+        {
+            const double referenceNsPerSample = referenceTimings[caseName].getDoubleValue();
+            timing << " (reference " << juce::String(referenceNsPerSample, 1) << ")";
+
+            if (result.wasOk() && maxSlowdown > 0.0 && nsPerSample > referenceNsPerSample * maxSlowdown)
+                result = juce::Result::fail("more than " + juce::String(maxSlowdown, 2) + "x slower than the reference");
+        }
+
+        std::cout << (result.wasOk() ? "PASS  " : "FAIL  ") << caseName
+                  << "  max " << toDecibelString(comparison.maxAbsError)
+                  << "  rms " << toDecibelString(comparison.rmsError)
+                  << "  spectral " << juce::String(comparison.spectralError, 3) << " dB"
+                  << "  " << timing;
+
+        if (result.failed())
+        {
+            std::cout << ": " << result.getErrorMessage();
+            ++numFailed;
+        }
+
+        std::cout << std::endl;
+    }
+
+    if (updateReference && !timingsFile.replaceWithText(newTimings))
+    {
+        std::cerr << "Couldn't write " << timingsFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << (jobs.size() - numFailed - numSkipped) << " of " << jobs.size() << " case(s) passed"
+              << (exact ? " (bit-exact)" : "");
+    if (numSkipped > 0)
+        std::cout << ", " << numSkipped << " skipped without a reference";
+    std::cout << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+// GoldenSuite.h
+#pragma once
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+// Golden-output regression suite: renders every patch x MIDI sequence pair through
+// OfflineRenderer and compares the result with a stored reference render.
+//
+//   Successor37 --render --suite <suite dir> [--out <dir>] [--exact | --tolerance <dBFS>]
+//               [--spectral-tolerance <dB>] [--max-slowdown <ratio>] [--update-reference]
+//
+// A suite directory holds presets/*.xml (PresetManager format, none = default patch),
+// midi/*.mid and reference/, which has one <preset>__<midi>.wav per case plus
+// timings.txt (ns/sample per case). --update-reference rewrites both. The suite the
+// project ships is Tests/GoldenSuite; the GoldenSuite MSBuild target runs it.
+//
+// Each case reports max abs error, RMS error and the spectral difference (RMS of the
+// per-bin dB difference over the audible bins of 2048-point frames). Tiers:
+//  - --exact: any difference fails. Renders are single-threaded 32-bit float unless
+//    --threads is given, so they're bit-exact on the same build and platform.
+//  - default: max abs error must stay under --tolerance (-80 dBFS) and the spectral
+//    difference under --spectral-tolerance (0.5 dB), for changes that are meant to
+//    sound the same but aren't bit-identical (vectorised kernels, reordered sums).
+// A case also fails if processing is slower than its reference ns/sample times
+// --max-slowdown (1.25, 0 disables). Timings only mean something on the machine that
+// made the references, so refresh them there before relying on the gate. A case with
+// no reference render is skipped, not failed, so the suite passes until one is recorded.
+class GoldenSuite
+{
+public:
+    struct Comparison
+    {
+        juce::Result result = juce::Result::ok(); // Fails on a length or channel mismatch
+        float maxAbsError = 0.0f;
+        float rmsError = 0.0f;
+        float spectralError = 0.0f; // dB
+    };
+
+    // Compares a render against its reference
+    static Comparison compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference);
+
+    // Command-line entry point, returns the process exit code
+    static int runCommandLine(const juce::ArgumentList& args, OfflineRenderer::Settings settings);
+
+private:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+
+    static float computeSpectralError(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference);
+    static juce::Result readAudioFile(const juce::File& file, juce::AudioBuffer<float>& buffer);
+
+    GoldenSuite() = delete;
+};
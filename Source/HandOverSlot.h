@@ -0,0 +1,59 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Single-slot hand-over from writer threads to the audio thread, for data the owner
+// keeps next to it (PresetManager's snapshot, MidiLearn's table). A writer takes the
+// slot if it's empty, or holds something the audio thread hasn't picked up yet, which
+// is overwritten; it waits out the few microseconds of a take in progress. The audio
+// thread never waits: take() finds the slot ready or does nothing.
+class HandOverSlot
+{
+public:
+    HandOverSlot() = default;
+
+    // Writer: fill() writes the pending data while the slot is held. Callers that need
+    // to order this with other state can hold their own lock around it.
+    template <typename Fill>
+    void publish(Fill&& fill)
+    {
+        for (;;) {
+            int expected = slotEmpty;
+            if (state.compare_exchange_strong(expected, slotWriting)) {
+                break;
+            }
+            expected = slotReady;
+            if (state.compare_exchange_strong(expected, slotWriting)) {
+                break;
+            }
+            juce::Thread::yield();
+        }
+
+        fill();
+        state.store(slotReady);
+    }
+
+    // Audio thread: read() copies the pending data out. Returns false if nothing was
+    // pending, in which case read() isn't called.
+    template <typename Read>
+    bool take(Read&& read) noexcept
+    {
+        int expected = slotReady;
+        if (!state.compare_exchange_strong(expected, slotApplying)) {
+            return false;
+        }
+
+        read();
+        state.store(slotEmpty);
+        return true;
+    }
+
+    bool isPending() const noexcept { return state.load() == slotReady; }
+
+private:
+    enum SlotState { slotEmpty, slotWriting, slotReady, slotApplying };
+    std::atomic<int> state { slotEmpty };
+
+    JUCE_DECLARE_NON_COPYABLE(HandOverSlot)
+};
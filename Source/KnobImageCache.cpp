@@ -0,0 +1,39 @@
+// KnobImageCache.cpp
+#include "KnobImageCache.h"
+
+juce::Image& KnobImageCache::findFrame(const Key& key, int numFrames, int frameIndex)
+{
+    auto& frameSet = frameSets[key];
+    if (frameSet.frames.size() != static_cast<size_t>(numFrames))
+    {
+        totalBytes -= frameSet.numBytes;
+        frameSet.frames.assign(static_cast<size_t>(numFrames), juce::Image());
+        frameSet.numBytes = 0;
+    }
+
+    frameSet.lastUsed = ++useCounter;
+    currentSet = &frameSet;
+    return frameSet.frames[static_cast<size_t>(juce::jlimit(0, numFrames - 1, frameIndex))];
+}
+
+void KnobImageCache::frameAdded(size_t numBytes)
+{
+    currentSet->numBytes += numBytes;
+    totalBytes += numBytes;
+
+    // Over budget: drop whole sizes, least recently drawn first. Resizing an editor
+    // by dragging leaves a trail of sizes that are never drawn again.
+    while (totalBytes > maxBytes)
+    {
+        auto oldest = frameSets.end();
+        for (auto it = frameSets.begin(); it != frameSets.end(); ++it)
+            if (&it->second != currentSet && (oldest == frameSets.end() || it->second.lastUsed < oldest->second.lastUsed))
+                oldest = it;
+
+        if (oldest == frameSets.end())
+            break;
+
+        totalBytes -= oldest->second.numBytes;
+        frameSets.erase(oldest);
+    }
+}
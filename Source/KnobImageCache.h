@@ -0,0 +1,76 @@
+// KnobImageCache.h
+#pragma once
+
+#include <JuceHeader.h>
+
+// Knob frames shared by every slider of every open editor in the process (hold it
+// through a juce::SharedResourcePointer). A frame is rendered the first time it's
+// needed at a given size and display scale, so each scale and editor size costs one
+// rendering per knob position however many instances are open. Sizes that
+// haven't been drawn for a while are dropped once the cache passes maxBytes.
+// Message thread only.
+class KnobImageCache
+{
+public:
+    static constexpr size_t maxBytes = 64 * 1024 * 1024;
+
+    KnobImageCache() = default;
+
+    // style tells apart knobs that are drawn differently (a filmstrip, the vector knob).
+    // On a miss, renderFrame(Graphics&) draws the frame into a blank image in logical
+    // coordinates (0, 0, width, height); the image itself has the physical size.
+    template <typename RenderFrame>
+    const juce::Image& getFrame(const void* style, int numFrames, int frameIndex,
+                                int width, int height, float scale, RenderFrame&& renderFrame)
+    {
+        const Key key { style, width, height, juce::jmax(1, juce::roundToInt(width * scale)),
+                        juce::jmax(1, juce::roundToInt(height * scale)) };
+
+        auto& frame = findFrame(key, numFrames, frameIndex);
+        if (frame.isNull())
+        {
+            frame = juce::Image(juce::Image::ARGB, key.pixelWidth, key.pixelHeight, true);
+            juce::Graphics g(frame);
+            g.addTransform(juce::AffineTransform::scale(key.pixelWidth / static_cast<float>(width),
+                                                        key.pixelHeight / static_cast<float>(height)));
+            renderFrame(g);
+            frameAdded(static_cast<size_t>(key.pixelWidth) * static_cast<size_t>(key.pixelHeight) * 4);
+        }
+        return frame;
+    }
+
+    size_t getNumBytes() const { return totalBytes; }
+
+private:
+    // Line widths are in logical pixels, so e.g. a 70px knob at 2x isn't the same
+    // image as a 140px knob at 1x
+    struct Key
+    {
+        const void* style;
+        int width, height;
+        int pixelWidth, pixelHeight;
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(style, width, height, pixelWidth, pixelHeight)
+                 < std::tie(other.style, other.width, other.height, other.pixelWidth, other.pixelHeight);
+        }
+    };
+
+    struct FrameSet
+    {
+        std::vector<juce::Image> frames;
+        juce::uint32 lastUsed = 0;
+        size_t numBytes = 0;
+    };
+
+    std::map<Key, FrameSet> frameSets;
+    FrameSet* currentSet = nullptr; // The one the last lookup used, never evicted
+    juce::uint32 useCounter = 0;
+    size_t totalBytes = 0;
+
+    juce::Image& findFrame(const Key& key, int numFrames, int frameIndex);
+    void frameAdded(size_t numBytes);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KnobImageCache)
+};
@@ -12,14 +12,12 @@ LFO::LFO() {
 
 void LFO::setSampleRate(double newSampleRate) {
     sampleRate = newSampleRate;
-    phaseIncrement = static_cast<float>(frequency / sampleRate);
+    updatePhaseIncrement();
 }
 
 void LFO::setFrequency(float frequencyHz) {
     frequency = juce::jlimit(0.01f, 100.0f, frequencyHz); // 0.01Hz to 100Hz
-    if (sampleRate > 0.0) {
-        phaseIncrement = static_cast<float>(frequency / sampleRate);
-    }
+    updatePhaseIncrement();
 }
 
 void LFO::setWaveform(int waveform) {
@@ -30,6 +28,73 @@ void LFO::setBipolar(bool isBipolar) {
     bipolar = isBipolar;
 }
 
+void LFO::setTempoSync(bool shouldSync) {
+    if (shouldSync != tempoSync) {
+        tempoSync = shouldSync;
+        lastTransportCycle = -1.0;
+        updatePhaseIncrement();
+    }
+}
+
+void LFO::setDivision(int division) {
+    division = juce::jlimit(0, NumDivisions - 1, division);
+    if (division != currentDivision) {
+        currentDivision = division;
+        lastTransportCycle = -1.0;
+        updatePhaseIncrement();
+    }
+}
+
+void LFO::syncToTransport(double bpm, double ppqPosition, bool isPlaying) {
+    if (!tempoSync) {
+        return;
+    }
+
+    if (bpm > 0.0 && bpm != tempoBpm) {
+        tempoBpm = bpm;
+        updatePhaseIncrement();
+    }
+
+    if (!isPlaying || keySync) {
+        return;
+    }
+
+    // Work out the phase from the song position in double precision, so it never
+    // drifts from the transport however long the song runs or however it loops
+    const double cycles = ppqPosition / getDivisionBeats(currentDivision);
+    const double cycle = std::floor(cycles);
+
+    if (cycle != lastTransportCycle) {
+        if (lastTransportCycle >= 0.0 && (currentWaveform == Random || currentWaveform == RandomSmooth)) {
+            pickNextRandomValue();
+        }
+        lastTransportCycle = cycle;
+    }
+
+    phase = static_cast<float>(cycles - cycle);
+}
+
+double LFO::getDivisionBeats(int division) {
+    static constexpr double beats[NumDivisions] = {
+        16.0, 8.0, 4.0,                 // 4 bars, 2 bars, 1 bar
+        2.0, 3.0, 4.0 / 3.0,            // 1/2, 1/2D, 1/2T
+        1.0, 1.5, 2.0 / 3.0,            // 1/4, 1/4D, 1/4T
+        0.5, 0.75, 1.0 / 3.0,           // 1/8, 1/8D, 1/8T
+        0.25, 0.375, 1.0 / 6.0,         // 1/16, 1/16D, 1/16T
+        0.125                           // 1/32
+    };
+    return beats[juce::jlimit(0, NumDivisions - 1, division)];
+}
+
+juce::StringArray LFO::getDivisionNames() {
+    return { "4 Bars", "2 Bars", "1 Bar",
+             "1/2", "1/2D", "1/2T",
+             "1/4", "1/4D", "1/4T",
+             "1/8", "1/8D", "1/8T",
+             "1/16", "1/16D", "1/16T",
+             "1/32" };
+}
+
 float LFO::getNextSample() {
     float output = 0.0f;
     
@@ -52,8 +117,7 @@ float LFO::getNextSample() {
         
         // For random waveforms, pick new target values on phase wrap
         if (currentWaveform == Random || currentWaveform == RandomSmooth) {
-            lastRandomValue = targetRandomValue;
-            targetRandomValue = random.nextFloat() * 2.0f - 1.0f;
+            pickNextRandomValue();
         }
     }
     
@@ -62,6 +126,7 @@ float LFO::getNextSample() {
         output = (output + 1.0f) * 0.5f;
     }
     
+    currentValue = output;
     return output;
 }
 
@@ -74,17 +139,19 @@ void LFO::skipSamples(int numSamples) {
         
         // Update random values if needed
         if (currentWaveform == Random || currentWaveform == RandomSmooth) {
-            lastRandomValue = targetRandomValue;
-            targetRandomValue = random.nextFloat() * 2.0f - 1.0f;
+            pickNextRandomValue();
         }
     }
 }
 
 void LFO::reset() {
     phase = 0.0f;
-    lastRandomValue = random.nextFloat() * 2.0f - 1.0f;
-    targetRandomValue = random.nextFloat() * 2.0f - 1.0f;
-    randomPhase = 0.0f;
+    lastRandomValue = random.nextBipolar();
+    targetRandomValue = random.nextBipolar();
+}
+
+void LFO::setRandomSeed(juce::uint32 seed) {
+    random.setSeed(seed);
 }
 
 void LFO::setPhase(float newPhase) {
@@ -120,20 +187,21 @@ float LFO::generateRandom() {
 }
 
 float LFO::generateRandomSmooth() {
-    // Smooth random - interpolate between values
-    if (currentWaveform != RandomSmooth) {
-        // Initialize if we just switched to this waveform
-        lastRandomValue = targetRandomValue;
-        randomPhase = 0.0f;
-    }
-    
-    // Linear interpolation between random values
-    randomPhase += phaseIncrement;
-    if (randomPhase >= 1.0f) {
-        randomPhase = 0.0f;
-        lastRandomValue = targetRandomValue;
-        targetRandomValue = random.nextFloat() * 2.0f - 1.0f;
+    // Smooth random - glide between the values picked on each phase wrap
+    return lastRandomValue + (targetRandomValue - lastRandomValue) * phase;
+}
+
+void LFO::pickNextRandomValue() {
+    lastRandomValue = targetRandomValue;
+    targetRandomValue = random.nextBipolar();
+}
+
+void LFO::updatePhaseIncrement() {
+    if (sampleRate <= 0.0) {
+        return;
     }
-    
-    return lastRandomValue + (targetRandomValue - lastRandomValue) * randomPhase;
+
+    const double cyclesPerSecond = tempoSync ? tempoBpm / 60.0 / getDivisionBeats(currentDivision)
+                                             : static_cast<double>(frequency);
+    phaseIncrement = static_cast<float>(cyclesPerSecond / sampleRate);
 }
\ No newline at end of file
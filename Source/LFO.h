@@ -2,6 +2,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FastRandom.h"
 
 class LFO {
 public:
@@ -13,6 +14,16 @@ public:
     void setRate(float rateHz) { setFrequency(rateHz); } // Alias for consistency
     void setWaveform(int waveform);
     void setBipolar(bool isBipolar); // -1 to +1 or 0 to +1 output
+
+    // Tempo sync: the rate comes from the host tempo and a note division instead of Hz
+    void setTempoSync(bool shouldSync);
+    void setDivision(int division);
+    void setKeySync(bool shouldRestartOnNote) { keySync = shouldRestartOnNote; }
+
+    // Call once per block before processing. While the host is playing, a tempo-synced
+    // LFO that isn't key-synced takes its phase straight from the PPQ position so it
+    // stays locked to the song; otherwise only the tempo is used for the rate.
+    void syncToTransport(double bpm, double ppqPosition, bool isPlaying);
     
     // Processing
     float getNextSample();
@@ -28,14 +39,42 @@ public:
         RandomSmooth,
         NumWaveforms
     };
+
+    // Divisions in musical time, dotted (D) and triplet (T) variants included
+    enum Division {
+        FourBars = 0,
+        TwoBars,
+        OneBar,
+        Half,
+        HalfDotted,
+        HalfTriplet,
+        Quarter,
+        QuarterDotted,
+        QuarterTriplet,
+        Eighth,
+        EighthDotted,
+        EighthTriplet,
+        Sixteenth,
+        SixteenthDotted,
+        SixteenthTriplet,
+        ThirtySecond,
+        NumDivisions
+    };
+
+    static double getDivisionBeats(int division); // Length of one cycle in quarter notes
+    static juce::StringArray getDivisionNames();
     
     // State control
     void reset();
     void setPhase(float phase); // 0.0 to 1.0
+    void setRandomSeed(juce::uint32 seed); // Random values drawn after this follow the seed
     
     // Utility functions
     bool isBipolar() const { return bipolar; }
+    bool isTempoSynced() const { return tempoSync; }
+    bool isKeySync() const { return keySync; }
     float getCurrentPhase() const { return phase; }
+    float getCurrentValue() const { return currentValue; } // Last output of getNextSample()
     
 private:
     // Waveform generation functions
@@ -45,20 +84,29 @@ private:
     float generateSquare();
     float generateRandom();
     float generateRandomSmooth();
+    void pickNextRandomValue();
+    void updatePhaseIncrement();
     
     // State variables
     double sampleRate = 44100.0;
     float frequency = 1.0f;
     float phase = 0.0f;
     float phaseIncrement = 0.0f;
+    float currentValue = 0.0f;
     int currentWaveform = Sine;
     bool bipolar = true; // -1 to +1 output
+
+    // Tempo sync state
+    bool tempoSync = false;
+    bool keySync = true;
+    int currentDivision = Quarter;
+    double tempoBpm = 120.0;
+    double lastTransportCycle = -1.0;
     
     // Random number generation
-    juce::Random random;
+    FastRandom random;
     float lastRandomValue = 0.0f;
     float targetRandomValue = 0.0f;
-    float randomPhase = 0.0f;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LFO)
 };
\ No newline at end of file
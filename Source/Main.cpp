@@ -9,6 +9,7 @@
 #include <JuceHeader.h>
 #include "../JuceLibraryCode/AppConfig.h"
 #include "MainComponent.h"
+#include "OfflineRenderer.h"
 
 //==============================================================================
 class Successor37Application  : public juce::JUCEApplication
@@ -26,6 +27,14 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Headless MIDI-to-audio rendering, see OfflineRenderer.h
+        if (OfflineRenderer::isRenderCommand (commandLine))
+        {
+            setApplicationReturnValue (OfflineRenderer::runCommandLine (commandLine));
+            quit();
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
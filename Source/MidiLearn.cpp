@@ -0,0 +1,532 @@
+// MidiLearn.cpp
+#include "MidiLearn.h"
+#include "BinaryState.h"
+
+MidiLearn::MidiLearn(const juce::Array<juce::RangedAudioParameter*>& parameters)
+    : parameterList(parameters)
+{
+    const auto numParameters = static_cast<size_t>(parameterList.size());
+    heldValues.resize(numParameters, -1.0f);
+    heldSequences.resize(numParameters);
+    gestureOpen.resize(numParameters);
+    lastMoveTimes.resize(numParameters);
+
+    startTimerHz(30);
+}
+
+MidiLearn::~MidiLearn()
+{
+    stopTimer();
+    endGestures(false);
+}
+
+//==============================================================================
+void MidiLearn::startLearning(int parameterIndex)
+{
+    learnedSource.store(-1);
+    learningParameter.store(parameterIndex);
+}
+
+void MidiLearn::cancelLearning()
+{
+    learningParameter.store(-1);
+    learnedSource.store(-1);
+}
+
+void MidiLearn::timerCallback()
+{
+    applyParameterChanges();
+    endGestures(true);
+
+    const int source = learnedSource.exchange(-1);
+    if (source < 0)
+        return;
+
+    const int parameterIndex = learningParameter.exchange(-1);
+    if (parameterIndex < 0)
+        return;
+
+    auto mapping = unpackSource(source);
+    mapping.parameterIndex = parameterIndex;
+    addMapping(mapping);
+}
+
+void MidiLearn::addMapping(const Mapping& mapping)
+{
+    if (!isValid(mapping))
+    {
+        jassertfalse;
+        return;
+    }
+
+    const juce::ScopedLock sl(mappingLock);
+    mappings.erase(std::remove_if(mappings.begin(), mappings.end(),
+                                  [&mapping](const Mapping& existing) { return overlaps(existing, mapping); }),
+                   mappings.end());
+
+    if (mappings.size() >= static_cast<size_t>(maxMappings))
+        return;
+
+    mappings.push_back(mapping);
+    publishTable();
+}
+
+void MidiLearn::removeMappings(int parameterIndex)
+{
+    const juce::ScopedLock sl(mappingLock);
+    mappings.erase(std::remove_if(mappings.begin(), mappings.end(),
+                                  [parameterIndex](const Mapping& existing) { return existing.parameterIndex == parameterIndex; }),
+                   mappings.end());
+    publishTable();
+}
+
+void MidiLearn::clearMappings()
+{
+    const juce::ScopedLock sl(mappingLock);
+    mappings.clear();
+    publishTable();
+}
+
+std::vector<MidiLearn::Mapping> MidiLearn::getMappings() const
+{
+    const juce::ScopedLock sl(mappingLock);
+    return mappings;
+}
+
+std::vector<MidiLearn::Mapping> MidiLearn::getMappings(int parameterIndex) const
+{
+    const juce::ScopedLock sl(mappingLock);
+    std::vector<Mapping> result;
+    for (const auto& mapping : mappings)
+        if (mapping.parameterIndex == parameterIndex)
+            result.push_back(mapping);
+    return result;
+}
+
+int MidiLearn::getParameterIndex(const juce::String& parameterID) const
+{
+    for (int i = 0; i < parameterList.size(); ++i)
+        if (parameterList.getUnchecked(i)->getParameterID() == parameterID)
+            return i;
+    return -1;
+}
+
+juce::String MidiLearn::describe(const Mapping& mapping)
+{
+    juce::String source;
+    switch (mapping.type)
+    {
+        case SourceType::controller:     source = "CC " + juce::String(mapping.number); break;
+        case SourceType::controller14Bit: source = "CC " + juce::String(mapping.number) + "/" + juce::String(mapping.number + 32); break;
+        case SourceType::nrpn:           source = "NRPN " + juce::String(mapping.number); break;
+    }
+    return source + " (ch " + juce::String(mapping.channel) + ")";
+}
+
+bool MidiLearn::isValid(const Mapping& mapping) const
+{
+    if (mapping.channel < 1 || mapping.channel > 16
+        || mapping.parameterIndex < 0 || mapping.parameterIndex >= parameterList.size())
+        return false;
+
+    const auto isReserved = [](int controller) { return controller == 6 || controller == 38 || (controller >= 98 && controller <= 101); };
+
+    switch (mapping.type)
+    {
+        case SourceType::controller:     return mapping.number >= 0 && mapping.number < 120 && !isReserved(mapping.number);
+        case SourceType::controller14Bit: return mapping.number >= 0 && mapping.number < 32 && !isReserved(mapping.number);
+        case SourceType::nrpn:           return mapping.number >= 0 && mapping.number < 16383; // 16383 is the null number
+    }
+    return false;
+}
+
+bool MidiLearn::overlaps(const Mapping& a, const Mapping& b)
+{
+    if (a.channel != b.channel)
+        return false;
+
+    const bool aIsNrpn = a.type == SourceType::nrpn;
+    const bool bIsNrpn = b.type == SourceType::nrpn;
+    if (aIsNrpn || bIsNrpn)
+        return aIsNrpn && bIsNrpn && a.number == b.number;
+
+    // A 14-bit controller also takes its LSB's number
+    const auto uses = [](const Mapping& m, int controller)
+    {
+        return controller == m.number || (m.type == SourceType::controller14Bit && controller == m.number + 32);
+    };
+    return uses(a, b.number) || (b.type == SourceType::controller14Bit && uses(a, b.number + 32));
+}
+
+//==============================================================================
+void MidiLearn::publishTable()
+{
+    // Overwrites a table the audio thread hasn't picked up yet
+    tableSlot.publish([this] { compileTable(); });
+}
+
+void MidiLearn::compileTable()
+{
+    pending = Table();
+    for (size_t i = 0; i < mappings.size(); ++i)
+    {
+        const auto& mapping = mappings[i];
+        const auto target = static_cast<juce::int16>(i);
+        const int channel = mapping.channel - 1;
+        const float span = mapping.maximum - mapping.minimum;
+
+        pending.targets[i] = { parameterList.getUnchecked(mapping.parameterIndex), mapping.minimum, span / 127.0f, span / 16383.0f,
+                               static_cast<juce::int16>(mapping.parameterIndex) };
+
+        auto& controllers = pending.controllers[static_cast<size_t>(channel)];
+        switch (mapping.type)
+        {
+            case SourceType::controller:
+                controllers[static_cast<size_t>(mapping.number)] = { controller7Bit, target };
+                break;
+            case SourceType::controller14Bit:
+                controllers[static_cast<size_t>(mapping.number)] = { controllerMsb, target };
+                controllers[static_cast<size_t>(mapping.number + 32)] = { controllerLsb, target };
+                break;
+            case SourceType::nrpn:
+                pending.nrpns[static_cast<size_t>(pending.numNrpns++)] = { static_cast<juce::int16>(channel), static_cast<juce::int16>(mapping.number), target };
+                break;
+        }
+    }
+}
+
+void MidiLearn::applyPendingTable() noexcept
+{
+    if (!tableSlot.take([this] { active = pending; }))
+        return;
+
+    // Changes still queued refer to the old targets; the values they hold stay held
+    for (int i = 0; i < numChangedTargets; ++i)
+        targetChanged[static_cast<size_t>(changedTargets[static_cast<size_t>(i)])] = false;
+    numChangedTargets = 0;
+
+    // Target indices may have moved
+    for (int channel = 0; channel < 16; ++channel)
+        resolveNrpn(channel);
+}
+
+//==============================================================================
+void MidiLearn::process(const juce::MidiBuffer& midiMessages) noexcept
+{
+    applyPendingTable();
+    releaseAppliedValues();
+
+    const bool learning = learningParameter.load(std::memory_order_relaxed) >= 0;
+
+    // Straight from the raw bytes: no MidiMessage is built for the events skipped
+    for (const auto metadata : midiMessages)
+    {
+        const auto* data = metadata.data;
+        if (metadata.numBytes != 3 || (data[0] & 0xf0) != 0xb0)
+            continue;
+
+        const int channel = data[0] & 0x0f;
+        const int controller = data[1] & 0x7f;
+        handleController(channel, controller, data[2] & 0x7f);
+
+        if (learning)
+            considerForLearning(channel, controller);
+    }
+
+    if (numChangedTargets > 0)
+        queueChangedTargets();
+}
+
+void MidiLearn::queueChangedTargets() noexcept
+{
+    // Queued values are held (and used) straight away; what doesn't fit in the queue
+    // stays changed and goes with the next block's changes
+    ++changeSequence;
+    const auto scope = changeFifo.write(numChangedTargets);
+    const int numWritten = scope.blockSize1 + scope.blockSize2;
+
+    for (int i = 0; i < numWritten; ++i)
+    {
+        const auto target = static_cast<size_t>(changedTargets[static_cast<size_t>(i)]);
+        const auto& targetInfo = active.targets[target];
+        const float value = juce::jlimit(0.0f, 1.0f, targetValues[target]);
+        targetChanged[target] = false;
+
+        const int fifoIndex = i < scope.blockSize1 ? scope.startIndex1 + i : scope.startIndex2 + i - scope.blockSize1;
+        changes[static_cast<size_t>(fifoIndex)] = { targetInfo.parameterIndex, value, changeSequence };
+
+        const auto parameterIndex = static_cast<size_t>(targetInfo.parameterIndex);
+        if (heldValues[parameterIndex] < 0.0f)
+            ++numHeld;
+        heldValues[parameterIndex] = value;
+        heldSequences[parameterIndex] = changeSequence;
+    }
+
+    std::copy(changedTargets.begin() + numWritten, changedTargets.begin() + numChangedTargets, changedTargets.begin());
+    numChangedTargets -= numWritten;
+}
+
+void MidiLearn::releaseAppliedValues() noexcept
+{
+    if (numHeld == 0)
+        return;
+
+    // The parameters now hold these values themselves
+    const auto applied = appliedSequence.load();
+    for (size_t i = 0; i < heldValues.size(); ++i)
+    {
+        if (heldValues[i] >= 0.0f && heldSequences[i] <= applied)
+        {
+            heldValues[i] = -1.0f;
+            --numHeld;
+        }
+    }
+}
+
+void MidiLearn::applyParameterChanges()
+{
+    const auto scope = changeFifo.read(changeFifo.getNumReady());
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return;
+
+    const auto now = juce::Time::getMillisecondCounter();
+    juce::uint64 lastSequence = 0;
+
+    auto apply = [&](const ParameterChange& change)
+    {
+        const auto index = static_cast<size_t>(change.parameterIndex);
+        auto* parameter = parameterList.getUnchecked(change.parameterIndex);
+
+        // One gesture per movement, so hosts record it like a knob being turned
+        if (!gestureOpen[index])
+        {
+            parameter->beginChangeGesture();
+            gestureOpen[index] = true;
+        }
+        lastMoveTimes[index] = now;
+
+        if (parameter->getValue() != change.value)
+            parameter->setValueNotifyingHost(change.value);
+        lastSequence = juce::jmax(lastSequence, change.sequence);
+    };
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        apply(changes[static_cast<size_t>(scope.startIndex1 + i)]);
+    for (int i = 0; i < scope.blockSize2; ++i)
+        apply(changes[static_cast<size_t>(scope.startIndex2 + i)]);
+
+    appliedSequence.store(lastSequence);
+}
+
+void MidiLearn::endGestures(bool idleOnly)
+{
+    const auto now = juce::Time::getMillisecondCounter();
+    for (size_t i = 0; i < gestureOpen.size(); ++i)
+    {
+        if (gestureOpen[i] && (!idleOnly || now - lastMoveTimes[i] >= gestureIdleMs))
+        {
+            parameterList.getUnchecked(static_cast<int>(i))->endChangeGesture();
+            gestureOpen[i] = false;
+        }
+    }
+}
+
+void MidiLearn::handleController(int channel, int controller, int value) noexcept
+{
+    auto& state = channels[static_cast<size_t>(channel)];
+
+    switch (controller)
+    {
+        case 99:
+            state.nrpnMsb = value;
+            resolveNrpn(channel);
+            return;
+        case 98:
+            state.nrpnLsb = value;
+            resolveNrpn(channel);
+            return;
+        case 101:
+        case 100:
+            state.nrpnSelected = false;
+            state.nrpnTarget = -1;
+            return;
+        case 6:
+            // The MSB alone covers the whole range, for senders that never send an LSB
+            state.dataMsb = value;
+            if (state.nrpnTarget >= 0)
+            {
+                const auto& target = active.targets[static_cast<size_t>(state.nrpnTarget)];
+                setTarget(state.nrpnTarget, target.offset + value * target.scale7Bit);
+            }
+            return;
+        case 38:
+            if (state.nrpnTarget >= 0)
+            {
+                const auto& target = active.targets[static_cast<size_t>(state.nrpnTarget)];
+                setTarget(state.nrpnTarget, target.offset + ((state.dataMsb << 7) | value) * target.scale14Bit);
+            }
+            return;
+        default:
+            break;
+    }
+
+    const auto& entry = active.controllers[static_cast<size_t>(channel)][static_cast<size_t>(controller)];
+    if (entry.type == unmapped)
+        return;
+
+    const auto& target = active.targets[static_cast<size_t>(entry.target)];
+    switch (entry.type)
+    {
+        case controller7Bit:
+            setTarget(entry.target, target.offset + value * target.scale7Bit);
+            break;
+        case controllerMsb:
+            state.controllerMsbs[static_cast<size_t>(controller)] = static_cast<juce::uint8>(value);
+            setTarget(entry.target, target.offset + value * target.scale7Bit);
+            break;
+        case controllerLsb:
+            setTarget(entry.target, target.offset + ((state.controllerMsbs[static_cast<size_t>(controller - 32)] << 7) | value) * target.scale14Bit);
+            break;
+        case unmapped:
+            break;
+    }
+}
+
+void MidiLearn::resolveNrpn(int channel) noexcept
+{
+    auto& state = channels[static_cast<size_t>(channel)];
+    state.nrpnSelected = !(state.nrpnMsb == 0x7f && state.nrpnLsb == 0x7f);
+    state.nrpnTarget = -1;
+    if (!state.nrpnSelected)
+        return;
+
+    // Only when a number is selected, so a scan of the few NRPN mappings is fine
+    const int number = (state.nrpnMsb << 7) | state.nrpnLsb;
+    for (int i = 0; i < active.numNrpns; ++i)
+    {
+        const auto& nrpn = active.nrpns[static_cast<size_t>(i)];
+        if (nrpn.channel == channel && nrpn.number == number)
+        {
+            state.nrpnTarget = nrpn.target;
+            return;
+        }
+    }
+}
+
+void MidiLearn::setTarget(int target, float normalisedValue) noexcept
+{
+    const auto index = static_cast<size_t>(target);
+    targetValues[index] = normalisedValue;
+    if (!targetChanged[index])
+    {
+        targetChanged[index] = true;
+        changedTargets[static_cast<size_t>(numChangedTargets++)] = static_cast<juce::int16>(target);
+    }
+}
+
+//==============================================================================
+int MidiLearn::packSource(SourceType type, int channel, int number) noexcept
+{
+    return (static_cast<int>(type) << 24) | (channel << 16) | number;
+}
+
+MidiLearn::Mapping MidiLearn::unpackSource(int source)
+{
+    Mapping mapping;
+    mapping.type = static_cast<SourceType>(source >> 24);
+    mapping.channel = ((source >> 16) & 0xff) + 1;
+    mapping.number = source & 0xffff;
+    return mapping;
+}
+
+void MidiLearn::considerForLearning(int channel, int controller) noexcept
+{
+    // Selecting a number isn't a move; data entry learns the selected NRPN
+    if (controller == 6 || controller == 38)
+    {
+        const auto& state = channels[static_cast<size_t>(channel)];
+        if (state.nrpnSelected)
+            learnedSource.store(packSource(SourceType::nrpn, channel, (state.nrpnMsb << 7) | state.nrpnLsb));
+        return;
+    }
+
+    if ((controller >= 98 && controller <= 101) || controller >= 120)
+        return;
+
+    // An LSB straight after its MSB makes the pair one 14-bit controller, and the
+    // pair's next MSB mustn't turn it back into a 7-bit one
+    if (controller >= 32 && controller < 64)
+    {
+        int expected = packSource(SourceType::controller, channel, controller - 32);
+        const int pair = packSource(SourceType::controller14Bit, channel, controller - 32);
+        if (learnedSource.compare_exchange_strong(expected, pair) || expected == pair)
+            return;
+    }
+    else if (controller < 32 && learnedSource.load() == packSource(SourceType::controller14Bit, channel, controller))
+    {
+        return;
+    }
+
+    learnedSource.store(packSource(SourceType::controller, channel, controller));
+}
+
+//==============================================================================
+void MidiLearn::writeState(juce::MemoryBlock& destData) const
+{
+    const juce::ScopedLock sl(mappingLock);
+
+    juce::MemoryOutputStream out(destData, false);
+    out.writeInt(1); // Version
+    out.writeInt(static_cast<int>(mappings.size()));
+
+    for (const auto& mapping : mappings)
+    {
+        out.writeInt(static_cast<int>(mapping.type));
+        out.writeInt(mapping.channel);
+        out.writeInt(mapping.number);
+        out.writeInt(static_cast<int>(BinaryState::hashParameterID(parameterList.getUnchecked(mapping.parameterIndex)->getParameterID())));
+        out.writeFloat(mapping.minimum);
+        out.writeFloat(mapping.maximum);
+    }
+
+    out.flush();
+    destData.setSize(out.getDataSize());
+}
+
+bool MidiLearn::restoreState(const void* data, size_t sizeInBytes)
+{
+    juce::MemoryInputStream in(data, sizeInBytes, false);
+    const int version = in.readInt();
+    const int numStored = in.readInt();
+    if (version < 1 || numStored < 0 || in.getNumBytesRemaining() < static_cast<juce::int64>(numStored) * 24)
+        return false;
+
+    std::vector<Mapping> restored;
+    for (int i = 0; i < numStored; ++i)
+    {
+        Mapping mapping;
+        mapping.type = static_cast<SourceType>(in.readInt());
+        mapping.channel = in.readInt();
+        mapping.number = in.readInt();
+        const auto hash = static_cast<juce::uint32>(in.readInt());
+        mapping.minimum = in.readFloat();
+        mapping.maximum = in.readFloat();
+
+        for (int index = 0; index < parameterList.size(); ++index)
+        {
+            if (BinaryState::hashParameterID(parameterList.getUnchecked(index)->getParameterID()) == hash)
+            {
+                mapping.parameterIndex = index;
+                break;
+            }
+        }
+
+        if (isValid(mapping) && restored.size() < static_cast<size_t>(maxMappings))
+            restored.push_back(mapping);
+    }
+
+    const juce::ScopedLock sl(mappingLock);
+    mappings = std::move(restored);
+    publishTable();
+    return true;
+}
@@ -0,0 +1,200 @@
+// MidiLearn.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "HandOverSlot.h"
+
+// Maps MIDI controllers to parameters. A source is a 7-bit CC, a 14-bit CC (MSB on
+// 0-31, LSB on the CC 32 above it) or an NRPN (selected with CC 99/98, data on 6/38).
+// A parameter can have any number of sources; a source drives one parameter.
+//
+// The mapping list belongs to the message thread. Every change compiles it into a
+// table that the audio thread takes over at the start of a block, through the same
+// HandOverSlot as PresetManager's snapshots. Dispatch is then one index into a 16 x 128
+// table per CC, whose entries already hold the parameter and its scaling; NRPN
+// numbers are resolved when they're selected, not per data byte.
+//
+// Nothing on the audio thread touches the parameters or the host. Each block queues
+// the last value every moved parameter received, and the voices use it straight away
+// (getControlledValue) while a timer on the message thread sets the parameters. A
+// controller movement is one change gesture, closed once it's been still a moment,
+// so a hardware sweep is one undo step rather than hundreds.
+class MidiLearn : private juce::Timer
+{
+public:
+    enum class SourceType { controller, controller14Bit, nrpn };
+
+    struct Mapping
+    {
+        SourceType type = SourceType::controller;
+        int channel = 1;            // 1-16
+        int number = 0;             // CC (the MSB's for 14-bit), or 0-16383 for NRPN
+        int parameterIndex = -1;    // In the parameter list
+        float minimum = 0.0f;       // Normalised values the controller's travel covers
+        float maximum = 1.0f;
+    };
+
+    static constexpr int maxMappings = 128;
+    static constexpr juce::uint32 stateChunkTag = 0x4944494d; // "MIDI"
+
+    // parameters is the list the indices refer to, normally PresetManager's
+    explicit MidiLearn(const juce::Array<juce::RangedAudioParameter*>& parameters);
+    ~MidiLearn() override;
+
+    //==============================================================================
+    // Message thread
+    // The next controller to move is mapped to the parameter
+    void startLearning(int parameterIndex);
+    void cancelLearning();
+    int getLearningParameter() const { return learningParameter.load(); }
+
+    // Replaces any mapping that uses the same controllers
+    void addMapping(const Mapping& mapping);
+    void removeMappings(int parameterIndex);
+    void clearMappings();
+
+    std::vector<Mapping> getMappings() const;
+    std::vector<Mapping> getMappings(int parameterIndex) const;
+    int getParameterIndex(const juce::String& parameterID) const;
+
+    // e.g. "CC 74 (ch 1)"
+    static juce::String describe(const Mapping& mapping);
+
+    // For a BinaryState chunk. Parameters are stored by ID hash, so mappings survive
+    // parameters being added or reordered; ones for unknown parameters are dropped.
+    void writeState(juce::MemoryBlock& destData) const;
+    bool restoreState(const void* data, size_t sizeInBytes);
+
+    //==============================================================================
+    // Audio thread, once per block before parameters are read
+    void process(const juce::MidiBuffer& midiMessages) noexcept;
+
+    // The value a controller set the parameter to, until the message thread has passed
+    // it on to the parameter; otherwise normalisedValue
+    float getControlledValue(int parameterIndex, float normalisedValue) const noexcept
+    {
+        const float held = heldValues[static_cast<size_t>(parameterIndex)];
+        return held >= 0.0f ? held : normalisedValue;
+    }
+
+private:
+    juce::Array<juce::RangedAudioParameter*> parameterList;
+
+    juce::CriticalSection mappingLock; // Never taken by the audio thread
+    std::vector<Mapping> mappings;
+
+    //==============================================================================
+    // The compiled form
+    enum EntryType : juce::uint8 { unmapped, controller7Bit, controllerMsb, controllerLsb };
+
+    struct Entry
+    {
+        EntryType type = unmapped;
+        juce::int16 target = -1;
+    };
+
+    struct Target
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        float offset = 0.0f;
+        float scale7Bit = 0.0f;     // Per step of a 7-bit value
+        float scale14Bit = 0.0f;    // Per step of a 14-bit value
+        juce::int16 parameterIndex = -1;
+    };
+
+    struct NrpnEntry
+    {
+        juce::int16 channel = 0;
+        juce::int16 number = 0;
+        juce::int16 target = -1;
+    };
+
+    struct Table
+    {
+        std::array<std::array<Entry, 128>, 16> controllers {};
+        std::array<Target, maxMappings> targets {};
+        std::array<NrpnEntry, maxMappings> nrpns {};
+        int numNrpns = 0;
+    };
+
+    Table active;   // Audio thread
+    Table pending;  // Written while tableSlot is held
+    HandOverSlot tableSlot;
+
+    void publishTable(); // Caller holds mappingLock
+    void compileTable(); // Into pending
+    void applyPendingTable() noexcept;
+
+    //==============================================================================
+    // Audio thread state
+    struct ChannelState
+    {
+        std::array<juce::uint8, 32> controllerMsbs {};
+        int nrpnMsb = 0x7f;
+        int nrpnLsb = 0x7f;
+        bool nrpnSelected = false;  // An RPN or the null number deselects it
+        int dataMsb = 0;
+        int nrpnTarget = -1;        // Resolved when the number is selected
+    };
+    std::array<ChannelState, 16> channels;
+
+    std::array<float, maxMappings> targetValues {};
+    std::array<bool, maxMappings> targetChanged {};
+    std::array<juce::int16, maxMappings> changedTargets {};
+    int numChangedTargets = 0;
+
+    //==============================================================================
+    // Values on their way to the parameters. Each block's changes share a sequence
+    // number; the audio thread holds a value until the timer has applied its sequence.
+    struct ParameterChange
+    {
+        juce::int16 parameterIndex = -1;
+        float value = 0.0f;
+        juce::uint64 sequence = 0;
+    };
+
+    static constexpr int changeFifoSize = 1024;
+    static constexpr juce::uint32 gestureIdleMs = 250;
+
+    juce::AbstractFifo changeFifo { changeFifoSize };
+    std::array<ParameterChange, changeFifoSize> changes {};
+    std::atomic<juce::uint64> appliedSequence { 0 };
+
+    juce::uint64 changeSequence = 0;            // Audio thread
+    std::vector<float> heldValues;              // Audio thread, -1 when not held
+    std::vector<juce::uint64> heldSequences;
+    int numHeld = 0;
+
+    std::vector<bool> gestureOpen;              // Message thread
+    std::vector<juce::uint32> lastMoveTimes;
+
+    void queueChangedTargets() noexcept;
+    void releaseAppliedValues() noexcept;
+    void applyParameterChanges();
+    void endGestures(bool idleOnly);
+
+    void handleController(int channel, int controller, int value) noexcept;
+    void resolveNrpn(int channel) noexcept;
+    void setTarget(int target, float normalisedValue) noexcept;
+
+    //==============================================================================
+    // Learning: the audio thread reports the source it saw, the timer maps it. The
+    // timer also applies parameter changes, so it always runs.
+    std::atomic<int> learningParameter { -1 };
+    std::atomic<int> learnedSource { -1 };
+
+    static int packSource(SourceType type, int channel, int number) noexcept;
+    static Mapping unpackSource(int source);
+    void considerForLearning(int channel, int controller) noexcept;
+
+    void timerCallback() override;
+
+    // Sources on CC 6/38 and 98-101 are taken by NRPN, 120 and up are channel mode
+    bool isValid(const Mapping& mapping) const;
+    static bool overlaps(const Mapping& a, const Mapping& b);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiLearn)
+};
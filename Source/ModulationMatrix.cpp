@@ -7,6 +7,9 @@ ModulationMatrix::ModulationMatrix() {
     // Initialize arrays
     baseValues.fill(0.0f);
     modulatedValues.fill(0.0f);
+    
+    // Voices change connections from the audio thread
+    connections.reserve(32);
 }
 
 void ModulationMatrix::addConnection(Source source, Destination destination, float amount) {
@@ -55,6 +58,20 @@ float ModulationMatrix::getDestinationValue(Destination dest) const {
     return 0.0f;
 }
 
+float ModulationMatrix::getModulatedValue(Destination dest, const SampleSources& sources) const {
+    if (dest < 0 || dest >= NumDestinations) {
+        return 0.0f;
+    }
+    
+    float value = baseValues[dest];
+    for (const auto& connection : connections) {
+        if (connection.destination == dest) {
+            value += getSourceValue(connection.source, sources) * connection.amount;
+        }
+    }
+    return constrain(dest, value);
+}
+
 void ModulationMatrix::setBaseValue(Destination dest, float value) {
     if (dest >= 0 && dest < NumDestinations) {
         baseValues[dest] = value;
@@ -87,12 +104,34 @@ float ModulationMatrix::getSourceValue(Source source, int sampleIndex) const {
         case PitchBend:
             return pitchBend;
             
+        case Sequencer:
+            return sequencer;
+            
         case None:
         default:
             return 0.0f;
     }
 }
 
+float ModulationMatrix::getSourceValue(Source source, const SampleSources& sources) const {
+    switch (source) {
+        case LFO1:
+            return sources.lfo1;
+            
+        case LFO2:
+            return sources.lfo2;
+            
+        case FilterEnv:
+            return sources.filterEnv;
+            
+        case AmpEnv:
+            return sources.ampEnv;
+            
+        default:
+            return getSourceValue(source, 0);
+    }
+}
+
 void ModulationMatrix::applyModulation(int sampleIndex) {
     for (const auto& connection : connections) {
         float sourceValue = getSourceValue(connection.source, sampleIndex);
@@ -101,41 +140,38 @@ void ModulationMatrix::applyModulation(int sampleIndex) {
         // Apply modulation to the destination
         int destIndex = static_cast<int>(connection.destination);
         if (destIndex >= 0 && destIndex < NumDestinations) {
-            modulatedValues[destIndex] = baseValues[destIndex] + modulationAmount;
-            
-            // Apply constraints based on destination
-            switch (connection.destination) {
-                case FilterCutoff:
-                    modulatedValues[destIndex] = juce::jlimit(20.0f, 20000.0f, modulatedValues[destIndex]);
-                    break;
-                    
-                case FilterResonance:
-                    modulatedValues[destIndex] = juce::jlimit(0.0f, 1.0f, modulatedValues[destIndex]);
-                    break;
-                    
-                case Osc1Pitch:
-                case Osc2Pitch:
-                    // Pitch modulation in semitones (±12 semitones max)
-                    modulatedValues[destIndex] = juce::jlimit(-12.0f, 12.0f, modulatedValues[destIndex]);
-                    break;
-                    
-                case Osc1PWM:
-                case Osc2PWM:
-                    // PWM modulation (0.1 to 0.9 duty cycle)
-                    modulatedValues[destIndex] = juce::jlimit(0.1f, 0.9f, modulatedValues[destIndex]);
-                    break;
-                    
-                case OscMix:
-                case AmpLevel:
-                case LFO1Amount:
-                case LFO2Amount:
-                    // 0.0 to 1.0 range
-                    modulatedValues[destIndex] = juce::jlimit(0.0f, 1.0f, modulatedValues[destIndex]);
-                    break;
-                    
-                default:
-                    break;
-            }
+            modulatedValues[destIndex] = constrain(connection.destination, baseValues[destIndex] + modulationAmount);
         }
     }
+}
+
+float ModulationMatrix::constrain(Destination dest, float value) {
+    // Apply constraints based on destination
+    switch (dest) {
+        case FilterCutoff:
+            return juce::jlimit(20.0f, 20000.0f, value);
+            
+        case FilterResonance:
+            return juce::jlimit(0.0f, 1.0f, value);
+            
+        case Osc1Pitch:
+        case Osc2Pitch:
+            // Pitch modulation in semitones (±12 semitones max)
+            return juce::jlimit(-12.0f, 12.0f, value);
+            
+        case Osc1PWM:
+        case Osc2PWM:
+            // PWM modulation (0.1 to 0.9 duty cycle)
+            return juce::jlimit(0.1f, 0.9f, value);
+            
+        case OscMix:
+        case AmpLevel:
+        case LFO1Amount:
+        case LFO2Amount:
+            // 0.0 to 1.0 range
+            return juce::jlimit(0.0f, 1.0f, value);
+            
+        default:
+            return value;
+    }
 }
\ No newline at end of file
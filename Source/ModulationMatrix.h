@@ -22,6 +22,7 @@ public:
         ModWheel,
         Aftertouch,
         PitchBend,
+        Sequencer,
         NumSources
     };
     
@@ -78,10 +79,21 @@ public:
     void setModWheel(float wheel) { modWheel = wheel; }
     void setAftertouch(float touch) { aftertouch = touch; }
     void setPitchBend(float bend) { pitchBend = bend; }
+    void setSequencer(float value) { sequencer = value; }
     
     // Processing
     void processBlock(int numSamples);
     
+    // Per-sample evaluation for a voice that runs its own LFOs and envelopes: it passes
+    // this sample's values in, so nothing is advanced. Constrained like processBlock.
+    struct SampleSources {
+        float lfo1 = 0.0f;
+        float lfo2 = 0.0f;
+        float filterEnv = 0.0f;
+        float ampEnv = 0.0f;
+    };
+    float getModulatedValue(Destination dest, const SampleSources& sources) const;
+    
     // Destination value access
     float getDestinationValue(Destination dest) const;
     void setBaseValue(Destination dest, float value);
@@ -101,6 +113,7 @@ private:
     float modWheel = 0.0f;
     float aftertouch = 0.0f;
     float pitchBend = 0.0f;
+    float sequencer = 0.0f; // Step sequencer modulation lane
     
     // Connections
     std::vector<Connection> connections;
@@ -111,7 +124,9 @@ private:
     
     // Helper functions
     float getSourceValue(Source source, int sampleIndex) const;
+    float getSourceValue(Source source, const SampleSources& sources) const;
     void applyModulation(int sampleIndex);
+    static float constrain(Destination dest, float value);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "MoogFilter.h"
 #include <cmath>
 #include <algorithm>
+#include <complex>
 
 // Custom clamp for compatibility if std::clamp is unavailable
 template <typename T>
@@ -36,6 +37,26 @@ void MoogFilter::setDrive(float driveAmount) {
     drive = std::max(0.0f, driveAmount);
 }
 
+void MoogFilter::matchCoefficients(const MoogFilter& other) {
+    cutoff = other.cutoff;
+    resonance = other.resonance;
+    drive = other.drive;
+    p = other.p;
+    k = other.k;
+}
+
+float MoogFilter::getMagnitudeResponse(float frequencyHz) const {
+    const float omega = 2.0f * static_cast<float>(M_PI) * frequencyHz / sampleRate;
+    const std::complex<float> zInverse = std::polar(1.0f, -omega);
+    
+    // Each stage is y[n] = p * (x[n] + x[n-1]) + (1 - p) * y[n-1]
+    const std::complex<float> stage = p * (1.0f + zInverse) / (1.0f - (1.0f - p) * zInverse);
+    const std::complex<float> stages = stage * stage * stage * stage;
+    
+    // The feedback reads y4 from the previous sample
+    return drive * std::abs(stages / (1.0f + k * zInverse * stages));
+}
+
 void MoogFilter::reset() {
     y1 = y2 = y3 = y4 = 0.0f;
     oldx = oldy1 = oldy2 = oldy3 = 0.0f;
@@ -83,4 +104,4 @@ void MoogFilter::process(float* buffer, int numSamples) {
     for (int i = 0; i < numSamples; ++i) {
         buffer[i] = processSample(buffer[i]);
     }
-}s
\ No newline at end of file
+}
\ No newline at end of file
@@ -14,6 +14,9 @@ public:
     void setResonance(float resonance);
     void setDrive(float driveAmount); // 0.0 to 1.0+
     
+    // Copy another filter's parameters and coefficients without recalculating them
+    void matchCoefficients(const MoogFilter& other);
+    
     // Reset the filter state
     void reset();
     
@@ -22,6 +25,11 @@ public:
     float getResonance() const { return resonance; }
     float getDrive() const { return drive; }
     
+    // Small-signal magnitude response at frequencyHz, worked out from p and k: four
+    // one-pole stages inside the one-sample-delayed feedback loop, with the input
+    // tanh taken as its slope at zero (the drive). Doesn't touch the filter state.
+    float getMagnitudeResponse(float frequencyHz) const;
+    
 private:
     float sampleRate;
     float cutoff;
@@ -0,0 +1,593 @@
+// OfflineRenderer.cpp
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "GoldenSuite.h"
+#include <iostream>
+
+namespace
+{
+    // Transport for the processor: always playing, tempo taken from the MIDI file
+    class RenderPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setBpm(bpm);
+            info.setPpqPosition(ppq);
+            info.setTimeInSamples(timeInSamples);
+            info.setTimeInSeconds(timeInSeconds);
+            info.setIsPlaying(true);
+            return info;
+        }
+
+        double bpm = 120.0;
+        double ppq = 0.0;
+        juce::int64 timeInSamples = 0;
+        double timeInSeconds = 0.0;
+    };
+
+    struct TempoChange
+    {
+        double time;
+        double bpm;
+    };
+
+    std::unique_ptr<juce::AudioFormatWriter> createWriter(const juce::File& file, double sampleRate,
+                                                          int numChannels, int bitDepth)
+    {
+        std::unique_ptr<juce::AudioFormat> format;
+        if (file.hasFileExtension("flac"))
+            format = std::make_unique<juce::FlacAudioFormat>();
+        else
+            format = std::make_unique<juce::WavAudioFormat>();
+
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return nullptr;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+                                                                                static_cast<unsigned int>(numChannels),
+                                                                                bitDepth, {}, 0));
+        if (writer != nullptr)
+            stream.release(); // Now owned by the writer
+
+        return writer;
+    }
+
+    juce::File resolveFile(const juce::String& path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+    }
+
+    // Saves and restores the state of numInstances processors in the binary format and
+    // in the XML format it replaced, the way a host autosaves a project
+    int runStateBenchmark(int numInstances)
+    {
+        constexpr int numRounds = 10;
+
+        std::vector<std::unique_ptr<Successor37AudioProcessor>> processors;
+        for (int i = 0; i < numInstances; ++i)
+            processors.push_back(std::make_unique<Successor37AudioProcessor>());
+
+        std::vector<juce::MemoryBlock> xmlStates(processors.size()), binaryStates(processors.size());
+        double xmlSave = 0.0, xmlLoad = 0.0, binarySave = 0.0, binaryLoad = 0.0;
+
+        auto time = [](double& total, auto&& function)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            function();
+            total += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        };
+
+        for (int round = 0; round < numRounds; ++round)
+        {
+            time(xmlSave, [&]
+            {
+                for (size_t i = 0; i < processors.size(); ++i)
+                {
+                    std::unique_ptr<juce::XmlElement> xml(processors[i]->getValueTreeState().copyState().createXml());
+                    juce::AudioProcessor::copyXmlToBinary(*xml, xmlStates[i]);
+                }
+            });
+
+            time(binarySave, [&]
+            {
+                for (size_t i = 0; i < processors.size(); ++i)
+                    processors[i]->getStateInformation(binaryStates[i]);
+            });
+
+            time(xmlLoad, [&]
+            {
+                for (size_t i = 0; i < processors.size(); ++i)
+                    processors[i]->setStateInformation(xmlStates[i].getData(), static_cast<int>(xmlStates[i].getSize()));
+            });
+
+            time(binaryLoad, [&]
+            {
+                for (size_t i = 0; i < processors.size(); ++i)
+                    processors[i]->setStateInformation(binaryStates[i].getData(), static_cast<int>(binaryStates[i].getSize()));
+            });
+        }
+
+        auto report = [numInstances](const char* name, double seconds, size_t bytes)
+        {
+            std::cout << name << "  save+load " << juce::String(seconds * 1.0e3 / numRounds, 3) << " ms for "
+                      << numInstances << " instances, " << bytes << " bytes each" << std::endl;
+        };
+
+        report("XML   ", xmlSave + xmlLoad, xmlStates.front().getSize());
+        report("Binary", binarySave + binaryLoad, binaryStates.front().getSize());
+        std::cout << "Save: XML " << juce::String(xmlSave * 1.0e6 / (numRounds * numInstances), 2) << " us, binary "
+                  << juce::String(binarySave * 1.0e6 / (numRounds * numInstances), 2) << " us per instance" << std::endl
+                  << "Load: XML " << juce::String(xmlLoad * 1.0e6 / (numRounds * numInstances), 2) << " us, binary "
+                  << juce::String(binaryLoad * 1.0e6 / (numRounds * numInstances), 2) << " us per instance" << std::endl;
+        return 0;
+    }
+
+    // Plays a rapid-fire pattern for numSeconds: a new note every block with short
+    // gates and a long release, plus a chord wider than the polyphony every 16 blocks,
+    // so voices are stolen constantly. Reports the time per sample and how many notes
+    // had to wait for a stolen voice's fade even though it wasn't the only choice.
+    int runVoiceBenchmark(double numSeconds)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 64;
+        constexpr int chordSize = 10;
+
+        Successor37AudioProcessor processor;
+        processor.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto* release = processor.getValueTreeState().getParameter("ampRelease");
+        release->setValueNotifyingHost(release->convertTo0to1(1.0f));
+
+        auto* allocator = dynamic_cast<VoiceAllocator*>(&processor.getSynth());
+        if (allocator == nullptr)
+            return 1;
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        std::array<bool, VoiceAllocator::maxVoices> wasWaiting {};
+        int numNotes = 0, numDelayedStarts = 0, numIdleWhileDelayed = 0;
+        double seconds = 0.0;
+
+        const auto numBlocks = static_cast<int>(numSeconds * sampleRate / blockSize);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            // Note-ons sit at the end of the block, so a start held back by a fade is
+            // still pending when the block returns
+            midi.clear();
+            const int note = 36 + (block * 7) % 48;
+            midi.addEvent(juce::MidiMessage::noteOff(1, 36 + ((block - 3) * 7 + 48) % 48), 0);
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), blockSize - 1);
+            ++numNotes;
+
+            if (block % 16 == 0)
+            {
+                for (int i = 0; i < chordSize; ++i)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, 90 + i, 0.6f), blockSize - 1);
+                numNotes += chordSize;
+            }
+            else if (block % 16 == 4)
+            {
+                for (int i = 0; i < chordSize; ++i)
+                    midi.addEvent(juce::MidiMessage::noteOff(1, 90 + i), 0);
+            }
+
+            buffer.clear();
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            for (int i = 0; i < allocator->getNumVoices(); ++i)
+            {
+                const bool waiting = allocator->getSynthVoice(i)->isWaitingForKillFade();
+                if (waiting && !wasWaiting[static_cast<size_t>(i)])
+                {
+                    ++numDelayedStarts;
+                    if (allocator->getNumFreeVoices() > 0)
+                        ++numIdleWhileDelayed;
+                }
+                wasWaiting[static_cast<size_t>(i)] = waiting;
+            }
+        }
+
+        std::cout << numNotes << " notes over " << juce::String(numSeconds, 1) << " s at " << blockSize << "-sample blocks: "
+                  << juce::String(seconds * 1.0e9 / (static_cast<double>(numBlocks) * blockSize), 1) << " ns per sample" << std::endl
+                  << numDelayedStarts << " starts waited for a stolen voice's fade, "
+                  << numIdleWhileDelayed << " of them with an idle voice available" << std::endl;
+        return 0;
+    }
+
+    // Holds 1, 2, 4... notes (up to the polyphony) of a heavy unison patch for numSeconds with every thread
+    // count from 1 up to the number of cores, and reports the time per sample and the
+    // speed-up over one thread: the multi-core scaling curve for each voice count.
+    int runScalingBenchmark(double numSeconds)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        const int maxThreads = juce::SystemStats::getNumCpus();
+        const int maxVoices = Successor37AudioProcessor().getSynth().getNumVoices();
+        const auto numBlocks = juce::jmax(1, static_cast<int>(numSeconds * sampleRate / blockSize));
+
+        std::cout << "Voices  Threads  ns/sample  Speed-up" << std::endl;
+
+        for (int numVoices = 1; numVoices <= maxVoices; numVoices *= 2)
+        {
+            double singleThreadSeconds = 0.0;
+
+            // More threads than voices can't help
+            for (int numThreads = 1; numThreads <= juce::jmin(maxThreads, numVoices); ++numThreads)
+            {
+                // Non-realtime rendering goes parallel from two voices up, whatever the parameters say
+                Successor37AudioProcessor processor;
+                processor.setMaxThreads(numThreads);
+                processor.setNonRealtime(true);
+                processor.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                auto setParameter = [&processor](const char* id, float value)
+                {
+                    auto* parameter = processor.getValueTreeState().getParameter(id);
+                    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+                };
+                setParameter("unisonVoices", 8.0f);
+                setParameter("osc2Level", 1.0f);
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+                for (int i = 0; i < numVoices; ++i)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, 48 + i * 3, 0.8f), 0);
+
+                double seconds = 0.0;
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    buffer.clear();
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    processor.processBlock(buffer, midi);
+                    seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                    midi.clear();
+                }
+
+                processor.releaseResources();
+
+                if (numThreads == 1)
+                    singleThreadSeconds = seconds;
+
+                std::cout << juce::String(numVoices).paddedLeft(' ', 6) << juce::String(numThreads).paddedLeft(' ', 9)
+                          << juce::String(seconds * 1.0e9 / (static_cast<double>(numBlocks) * blockSize), 1).paddedLeft(' ', 11)
+                          << juce::String(singleThreadSeconds / seconds, 2).paddedLeft(' ', 9) << "x" << std::endl;
+            }
+        }
+        return 0;
+    }
+
+    // Paints the editor numFrames times at 1x and 2x scale and reports the time per
+    // frame. Every frame moves all the parameters first, as heavy automation would,
+    // so each knob shows a new position.
+    int runGuiBenchmark(int numFrames)
+    {
+        Successor37AudioProcessor processor;
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+        auto* synthEditor = dynamic_cast<Successor37AudioProcessorEditor*>(editor.get());
+        if (synthEditor == nullptr)
+            return 1;
+
+        for (const float scale : { 1.0f, 2.0f })
+        {
+            juce::Random random(1);
+            double firstFrame = 0.0, frames = 0.0;
+
+            for (int frame = 0; frame <= numFrames; ++frame)
+            {
+                for (auto* parameter : processor.getParameters())
+                    parameter->setValueNotifyingHost(random.nextFloat());
+                synthEditor->getRepaintThrottler().updateNow();
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                editor->createComponentSnapshot(editor->getLocalBounds(), true, scale);
+                const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+                // The first frame fills the image caches at this scale
+                if (frame == 0)
+                    firstFrame = seconds;
+                else
+                    frames += seconds;
+            }
+
+            std::cout << juce::String(scale, 0) << "x scale: first frame " << juce::String(firstFrame * 1.0e3, 3)
+                      << " ms, then " << juce::String(frames * 1.0e3 / numFrames, 3) << " ms per frame over "
+                      << numFrames << " frames" << std::endl;
+        }
+        return 0;
+    }
+}
+
+OfflineRenderer::OfflineRenderer(const Settings& newSettings)
+    : settings(newSettings)
+{
+}
+
+OfflineRenderer::Outcome OfflineRenderer::render(const Job& job) const
+{
+    Outcome outcome;
+    juce::MidiMessageSequence sequence;
+    outcome.result = readMidiFile(job.midiFile, sequence);
+    if (outcome.result.failed())
+        return outcome;
+
+    // Tempo map, for the play head. Before the first tempo event MIDI files run at 120 bpm.
+    std::vector<TempoChange> tempoChanges;
+    for (const auto* event : sequence)
+        if (event->message.isTempoMetaEvent())
+            tempoChanges.push_back({ event->message.getTimeStamp(), 60.0 / event->message.getTempoSecondsPerQuarterNote() });
+
+    const double sampleRate = settings.sampleRate;
+    const int blockSize = settings.blockSize;
+    const auto totalSamples = static_cast<juce::int64>(std::ceil((sequence.getEndTime() + settings.tailSeconds) * sampleRate));
+
+    auto processor = std::make_unique<Successor37AudioProcessor>();
+    RenderPlayHead playHead;
+    processor->setPlayHead(&playHead);
+    processor->setMaxThreads(settings.numThreads);
+    processor->setNonRealtime(true);
+    processor->setPlayConfigDetails(0, 2, sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    if (job.presetFile != juce::File())
+    {
+        auto* presetManager = processor->getPresetManager();
+        if (presetManager == nullptr || !presetManager->loadPresetFile(job.presetFile))
+        {
+            outcome.result = juce::Result::fail("Couldn't load preset " + job.presetFile.getFullPathName());
+            return outcome;
+        }
+    }
+
+    auto writer = createWriter(job.outputFile, sampleRate, 2, settings.bitDepth);
+    if (writer == nullptr)
+    {
+        outcome.result = juce::Result::fail("Couldn't write " + job.outputFile.getFullPathName());
+        return outcome;
+    }
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    int nextEvent = 0;
+    size_t nextTempoChange = 0;
+
+    for (juce::int64 blockStart = 0; blockStart < totalSamples; blockStart += blockSize)
+    {
+        const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalSamples - blockStart));
+        const double blockTime = static_cast<double>(blockStart) / sampleRate;
+
+        while (nextTempoChange < tempoChanges.size() && tempoChanges[nextTempoChange].time <= blockTime)
+            playHead.bpm = tempoChanges[nextTempoChange++].bpm;
+
+        playHead.timeInSamples = blockStart;
+        playHead.timeInSeconds = blockTime;
+
+        midi.clear();
+        for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+        {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            const auto samplePosition = juce::roundToInt(message.getTimeStamp() * sampleRate);
+            if (samplePosition >= blockStart + numSamples)
+                break;
+
+            if (!message.isMetaEvent())
+                midi.addEvent(message, static_cast<int>(juce::jmax(static_cast<juce::int64>(0), samplePosition - blockStart)));
+        }
+
+        buffer.setSize(2, numSamples, false, false, true);
+        buffer.clear();
+        const auto processStart = juce::Time::getHighResolutionTicks();
+        processor->processBlock(buffer, midi);
+        outcome.processSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - processStart);
+        outcome.numSamples += numSamples;
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            outcome.result = juce::Result::fail("Write error in " + job.outputFile.getFullPathName());
+            return outcome;
+        }
+
+        // Tempo changes are applied at block boundaries, so PPQ is accurate to one block
+        playHead.ppq += numSamples / sampleRate * playHead.bpm / 60.0;
+    }
+
+    processor->releaseResources();
+    return outcome;
+}
+
+std::vector<OfflineRenderer::Outcome> OfflineRenderer::renderBatch(const juce::Array<Job>& jobs, int numParallel) const
+{
+    std::vector<Outcome> results(static_cast<size_t>(jobs.size()));
+
+    juce::ThreadPool pool(juce::jlimit(1, juce::jmax(1, jobs.size()), numParallel));
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        pool.addJob([this, &jobs, &results, i]
+        {
+            results[static_cast<size_t>(i)] = render(jobs.getReference(i));
+            return juce::ThreadPoolJob::jobHasFinished;
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(20);
+
+    return results;
+}
+
+juce::Result OfflineRenderer::readMidiFile(const juce::File& file, juce::MidiMessageSequence& sequence)
+{
+    juce::FileInputStream stream(file);
+    if (!stream.openedOk())
+        return juce::Result::fail("Couldn't open " + file.getFullPathName());
+
+    juce::MidiFile midiFile;
+    if (!midiFile.readFrom(stream))
+        return juce::Result::fail("Not a Standard MIDI File: " + file.getFullPathName());
+
+    midiFile.convertTimestampTicksToSeconds();
+
+    sequence.clear();
+    for (int track = 0; track < midiFile.getNumTracks(); ++track)
+        sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+    sequence.sort();
+    sequence.updateMatchedPairs();
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::parseBatchFile(const juce::File& file, juce::Array<Job>& jobs)
+{
+    if (!file.existsAsFile())
+        return juce::Result::fail("Couldn't open " + file.getFullPathName());
+
+    juce::StringArray lines;
+    file.readLines(lines);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        const auto line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+
+        auto fields = juce::StringArray::fromTokens(line, "\t", "\"");
+        fields.trim();
+        fields.removeEmptyStrings();
+
+        if (fields.size() < 2 || fields.size() > 3)
+            return juce::Result::fail(file.getFileName() + " line " + juce::String(i + 1)
+                                      + ": expected <midi file> <tab> <output file> [<tab> <preset file>]");
+
+        // Relative paths are relative to the batch file
+        Job job;
+        job.midiFile = file.getSiblingFile(fields[0].unquoted());
+        job.outputFile = file.getSiblingFile(fields[1].unquoted());
+        if (fields.size() == 3)
+            job.presetFile = file.getSiblingFile(fields[2].unquoted());
+
+        jobs.add(job);
+    }
+
+    return juce::Result::ok();
+}
+
+bool OfflineRenderer::isRenderCommand(const juce::String& commandLine)
+{
+    return juce::ArgumentList("Successor37", commandLine).containsOption("--render");
+}
+
+int OfflineRenderer::runCommandLine(const juce::String& commandLine)
+{
+    const juce::ArgumentList args("Successor37", commandLine);
+
+    if (args.containsOption("--state-benchmark"))
+        return runStateBenchmark(args.containsOption("--instances") ? juce::jmax(1, args.getValueForOption("--instances").getIntValue()) : 100);
+
+    if (args.containsOption("--gui-benchmark"))
+        return runGuiBenchmark(args.containsOption("--frames") ? juce::jmax(1, args.getValueForOption("--frames").getIntValue()) : 200);
+
+    if (args.containsOption("--voice-benchmark"))
+        return runVoiceBenchmark(args.containsOption("--seconds") ? juce::jmax(1.0, args.getValueForOption("--seconds").getDoubleValue()) : 10.0);
+
+    if (args.containsOption("--scaling-benchmark"))
+        return runScalingBenchmark(args.containsOption("--seconds") ? juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue()) : 5.0);
+
+    const bool isBatch = args.containsOption("--batch") || args.containsOption("--suite");
+
+    Settings settings;
+    if (args.containsOption("--rate"))
+        settings.sampleRate = juce::jlimit(8000.0, 384000.0, args.getValueForOption("--rate").getDoubleValue());
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(1, 8192, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--bits"))
+        settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+    if (args.containsOption("--tail"))
+        settings.tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+    // A batch already uses every core across processors, so each one renders on its own thread.
+    // The golden suite also wants single-threaded renders, which are deterministic.
+    if (args.containsOption("--threads"))
+        settings.numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+    else if (isBatch)
+        settings.numThreads = 1;
+
+    if (settings.bitDepth != 16 && settings.bitDepth != 24 && settings.bitDepth != 32)
+    {
+        std::cerr << "--bits must be 16, 24 or 32" << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption("--suite"))
+        return GoldenSuite::runCommandLine(args, settings);
+
+    juce::Array<Job> jobs;
+    if (isBatch)
+    {
+        auto result = parseBatchFile(resolveFile(args.getValueForOption("--batch")), jobs);
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        if (!args.containsOption("--midi") || !args.containsOption("--out"))
+        {
+            std::cerr << "Usage: Successor37 --render --midi <file.mid> --out <file.wav|.flac> [--preset <preset.xml>]" << std::endl
+                      << "       Successor37 --render --batch <jobs.txt> [--jobs <n>]" << std::endl
+                      << "       Successor37 --render --suite <suite dir> [--exact] [--update-reference]" << std::endl
+                      << "       Successor37 --render --state-benchmark [--instances <n>]" << std::endl
+                      << "       Successor37 --render --gui-benchmark [--frames <n>]" << std::endl
+                      << "       Successor37 --render --voice-benchmark [--seconds <n>]" << std::endl
+                      << "       Successor37 --render --scaling-benchmark [--seconds <n>]" << std::endl
+                      << "Options: --rate <Hz> --block <samples> --threads <n> --bits <16|24|32> --tail <seconds>" << std::endl;
+            return 1;
+        }
+
+        Job job;
+        job.midiFile = resolveFile(args.getValueForOption("--midi"));
+        job.outputFile = resolveFile(args.getValueForOption("--out"));
+        if (args.containsOption("--preset"))
+            job.presetFile = resolveFile(args.getValueForOption("--preset"));
+
+        jobs.add(job);
+    }
+
+    const int numParallel = args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue()
+                                                          : juce::SystemStats::getNumCpus();
+
+    OfflineRenderer renderer(settings);
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    const auto results = renderer.renderBatch(jobs, numParallel);
+    const auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    int numFailed = 0;
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        const auto& result = results[static_cast<size_t>(i)].result;
+        if (result.wasOk())
+        {
+            std::cout << jobs[i].outputFile.getFullPathName() << std::endl;
+        }
+        else
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            ++numFailed;
+        }
+    }
+
+    std::cout << "Rendered " << (jobs.size() - numFailed) << " of " << jobs.size()
+              << " file(s) in " << juce::String(elapsedSeconds, 2) << "s" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+// OfflineRenderer.h
+#pragma once
+
+#include <JuceHeader.h>
+
+// Renders Standard MIDI Files through Successor37AudioProcessor without a host,
+// writing WAV or FLAC (picked from the output file's extension).
+//
+// Used by the app's headless command-line mode:
+//
+//   Successor37 --render --midi <file.mid> --out <file.wav|.flac> [--preset <preset.xml>]
+//   Successor37 --render --batch <jobs.txt> [--jobs <n>]
+//
+// Common options: --rate <Hz> (48000), --block <samples> (512), --threads <n>
+// (threads per processor, default all cores or 1 in batch mode), --bits <16|24|32>
+// (24) and --tail <seconds> (2). A batch file has one job per line:
+// <midi file> <tab> <output file> [<tab> <preset file>], '#' starts a comment.
+// --suite runs the golden-output regression suite instead, see GoldenSuite.h, and
+// --state-benchmark [--instances <n>] times state save/load for n processors (100),
+// --gui-benchmark [--frames <n>] times editor painting at 1x and 2x scale (200),
+// --voice-benchmark [--seconds <n>] plays rapid-fire notes with constant voice
+// stealing and counts note starts delayed by a stolen voice's fade (10), and
+// --scaling-benchmark [--seconds <n>] times 1, 2, 4... held voices rendered on 1 to N
+// cores and reports the speed-up over one core (5).
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numThreads = 0; // Per processor, including the rendering thread; 0 = all cores
+        int bitDepth = 24;
+        double tailSeconds = 2.0;
+    };
+
+    struct Job
+    {
+        juce::File midiFile;
+        juce::File outputFile;
+        juce::File presetFile; // Optional, PresetManager XML format
+    };
+
+    struct Outcome
+    {
+        juce::Result result = juce::Result::ok();
+        juce::int64 numSamples = 0;   // Per channel
+        double processSeconds = 0.0;  // Time spent in processBlock, excluding file I/O
+
+        double getNanosecondsPerSample() const { return numSamples > 0 ? processSeconds * 1.0e9 / static_cast<double>(numSamples) : 0.0; }
+    };
+
+    explicit OfflineRenderer(const Settings& settings);
+
+    // Renders one job with its own processor instance
+    Outcome render(const Job& job) const;
+
+    // Renders jobs numParallel at a time, one processor instance per job.
+    // Returns one outcome per job, in the same order.
+    std::vector<Outcome> renderBatch(const juce::Array<Job>& jobs, int numParallel) const;
+
+    // Command-line entry point, returns the process exit code
+    static bool isRenderCommand(const juce::String& commandLine);
+    static int runCommandLine(const juce::String& commandLine);
+
+private:
+    Settings settings;
+
+    // Merges every track, timestamps in seconds
+    static juce::Result readMidiFile(const juce::File& file, juce::MidiMessageSequence& sequence);
+    static juce::Result parseBatchFile(const juce::File& file, juce::Array<Job>& jobs);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -0,0 +1,242 @@
+// OscillatorBank.cpp
+#include "OscillatorBank.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Polynomial band-limited step, subtracted around a discontinuity at t = 0
+    inline float polyBlep(float t, float dt) {
+        if (t < dt) {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+        if (t > 1.0f - dt) {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+        return 0.0f;
+    }
+}
+
+OscillatorBank::OscillatorBank() {
+    // Spread the starting phases so stacked lanes don't start out phase-locked
+    for (int lane = 0; lane < maxUnisonVoices; ++lane) {
+        phases[lane] = std::fmod(lane * 0.618034f, 1.0f);
+        osc2Phases[lane] = phases[lane];
+    }
+    phases[0] = 0.0f;
+    osc2Phases[0] = 0.0f;
+
+    updateLaneLayout();
+}
+
+void OscillatorBank::setSampleRate(float newSampleRate) {
+    sampleRate = newSampleRate;
+    updateIncrements();
+}
+
+void OscillatorBank::setFrequency(float frequency) {
+    currentFrequency = frequency;
+    updateIncrements();
+}
+
+void OscillatorBank::setWaveform(int waveform) {
+    currentWaveform = juce::jlimit(0, 3, waveform);
+}
+
+void OscillatorBank::setOsc2Waveform(int waveform) {
+    osc2Waveform = juce::jlimit(0, 3, waveform);
+}
+
+void OscillatorBank::setOsc2Tune(float semitones, float cents) {
+    const float ratio = std::pow(2.0f, (semitones + cents * 0.01f) / 12.0f);
+    if (ratio != osc2Ratio) {
+        osc2Ratio = ratio;
+        updateIncrements();
+    }
+}
+
+void OscillatorBank::setLevels(float osc1, float osc2, float sub, float noiseAmount) {
+    osc1Level = osc1;
+    osc2Level = osc2;
+    subLevel = sub;
+    noiseLevel = noiseAmount;
+}
+
+void OscillatorBank::setNoiseSeed(juce::uint32 seed) {
+    // Drop what's left of the old block so the note's noise starts from the seed
+    noise.setSeed(seed);
+    noisePosition = noiseBlockSize;
+}
+
+void OscillatorBank::setUnison(int numVoices, float detuneCents, float spread) {
+    numVoices = juce::jlimit(1, maxUnisonVoices, numVoices);
+    detuneCents = juce::jmax(0.0f, detuneCents);
+    spread = juce::jlimit(0.0f, 1.0f, spread);
+
+    if (numVoices == numLanes && detuneCents == detune && spread == stereoSpread) {
+        return;
+    }
+
+    numLanes = numVoices;
+    detune = detuneCents;
+    stereoSpread = spread;
+    updateLaneLayout();
+}
+
+void OscillatorBank::process(float& left, float& right, float pulseWidth1, float pulseWidth2) {
+    const int lanes = numProcessLanes;
+    const bool useOsc2 = osc2Level != 0.0f;
+
+    // Oscillator 1: render, then advance and wrap every lane without branching.
+    // syncFractions holds how far past the wrap each lane is (in samples), or -1.
+    renderLanes(currentWaveform, phases.data(), increments.data(), pulseWidth1, laneOutput.data(), lanes);
+
+    for (int lane = 0; lane < lanes; ++lane) {
+        phases[lane] += increments[lane];
+        const bool wrapped = phases[lane] >= 1.0f;
+        phases[lane] -= wrapped ? 1.0f : 0.0f;
+        syncFractions[lane] = wrapped ? phases[lane] / increments[lane] : -1.0f;
+    }
+
+    // Oscillator 2, restarted from the sub-sample wrap position of oscillator 1 when synced
+    if (useOsc2) {
+        renderLanes(osc2Waveform, osc2Phases.data(), osc2Increments.data(), pulseWidth2, osc2Output.data(), lanes);
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            osc2Phases[lane] += osc2Increments[lane];
+            osc2Phases[lane] -= (osc2Phases[lane] >= 1.0f) ? 1.0f : 0.0f;
+        }
+
+        if (hardSync) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                const float syncedPhase = syncFractions[lane] * osc2Increments[lane];
+                osc2Phases[lane] = (syncFractions[lane] >= 0.0f) ? syncedPhase : osc2Phases[lane];
+            }
+        }
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            laneOutput[lane] = laneOutput[lane] * osc1Level + osc2Output[lane] * osc2Level;
+        }
+    } else if (osc1Level != 1.0f) {
+        for (int lane = 0; lane < lanes; ++lane) {
+            laneOutput[lane] *= osc1Level;
+        }
+    }
+
+    // Pan lanes into the stereo pair
+    float sumLeft = 0.0f;
+    float sumRight = 0.0f;
+    for (int lane = 0; lane < lanes; ++lane) {
+        sumLeft += laneOutput[lane] * leftGains[lane];
+        sumRight += laneOutput[lane] * rightGains[lane];
+    }
+
+    // Sub oscillator (square, one octave below oscillator 1) and noise sit in the centre
+    float centre = 0.0f;
+    if (subLevel != 0.0f) {
+        float sub = (subPhase < 0.5f) ? 1.0f : -1.0f;
+        sub += polyBlep(subPhase, subIncrement);
+        sub -= polyBlep(std::fmod(subPhase + 0.5f, 1.0f), subIncrement);
+        centre += sub * subLevel;
+
+        subPhase += subIncrement;
+        subPhase -= (subPhase >= 1.0f) ? 1.0f : 0.0f;
+    }
+
+    if (noiseLevel != 0.0f) {
+        if (noisePosition == noiseBlockSize) {
+            noise.fillBipolar(noiseBlock.data(), noiseBlockSize);
+            noisePosition = 0;
+        }
+        centre += noiseBlock[static_cast<size_t>(noisePosition++)] * noiseLevel;
+    }
+
+    left = sumLeft + centre;
+    right = sumRight + centre;
+}
+
+void OscillatorBank::renderLanes(int waveform, const float* lanePhases, const float* laneIncrements,
+                                 float pulseWidth, float* output, int lanes) {
+    switch (waveform) {
+        case 0:
+            for (int lane = 0; lane < lanes; ++lane) {
+                output[lane] = std::sin(2.0f * static_cast<float>(M_PI) * lanePhases[lane]);
+            }
+            break;
+
+        case 1:
+            for (int lane = 0; lane < lanes; ++lane) {
+                output[lane] = 2.0f * lanePhases[lane] - 1.0f - polyBlep(lanePhases[lane], laneIncrements[lane]);
+            }
+            break;
+
+        case 2: {
+            // Pulse: rising edge at phase 0, falling edge at the pulse width
+            const float width = juce::jlimit(0.05f, 0.95f, pulseWidth);
+            for (int lane = 0; lane < lanes; ++lane) {
+                const float phase = lanePhases[lane];
+                const float dt = laneIncrements[lane];
+                float fallingPhase = phase - width;
+                fallingPhase += (fallingPhase < 0.0f) ? 1.0f : 0.0f;
+
+                float value = (phase < width) ? 1.0f : -1.0f;
+                value += polyBlep(phase, dt);
+                value -= polyBlep(fallingPhase, dt);
+                output[lane] = value;
+            }
+            break;
+        }
+
+        case 3:
+        default:
+            for (int lane = 0; lane < lanes; ++lane) {
+                const float rising = 4.0f * lanePhases[lane] - 1.0f;
+                const float falling = 3.0f - 4.0f * lanePhases[lane];
+                output[lane] = (lanePhases[lane] < 0.5f) ? rising : falling;
+            }
+            break;
+    }
+}
+
+void OscillatorBank::updateIncrements() {
+    const float baseIncrement = currentFrequency / sampleRate;
+    for (int lane = 0; lane < maxUnisonVoices; ++lane) {
+        increments[lane] = baseIncrement * detuneRatios[lane];
+        osc2Increments[lane] = increments[lane] * osc2Ratio;
+    }
+    subIncrement = baseIncrement * 0.5f;
+}
+
+void OscillatorBank::updateLaneLayout() {
+    numProcessLanes = (numLanes + 3) & ~3;
+    stereo = numLanes > 1 && stereoSpread > 0.0f;
+
+    // Keep the summed level roughly constant as lanes are added
+    const float laneGain = 1.0f / std::sqrt(static_cast<float>(numLanes));
+
+    for (int lane = 0; lane < maxUnisonVoices; ++lane) {
+        if (lane >= numLanes) {
+            // Padding lanes still run but contribute nothing
+            detuneRatios[lane] = 1.0f;
+            leftGains[lane] = 0.0f;
+            rightGains[lane] = 0.0f;
+            continue;
+        }
+
+        // Position in the stack, -1 (lowest/leftmost) to +1 (highest/rightmost)
+        const float position = numLanes > 1 ? (2.0f * lane / (numLanes - 1)) - 1.0f : 0.0f;
+
+        detuneRatios[lane] = std::pow(2.0f, position * detune / 1200.0f);
+
+        // Balance law: a centred lane stays at unity in both channels
+        const float pan = position * stereoSpread;
+        leftGains[lane] = laneGain * juce::jmin(1.0f, 1.0f - pan);
+        rightGains[lane] = laneGain * juce::jmin(1.0f, 1.0f + pan);
+    }
+
+    updateIncrements();
+}
@@ -0,0 +1,90 @@
+// OscillatorBank.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "FastRandom.h"
+
+// All of a voice's sound sources for one note, rendered by a single fused
+// kernel: oscillators 1 and 2 as stacks of detuned unison lanes (with
+// optional hard sync of 2 to 1), a sub oscillator an octave below
+// oscillator 1, and white noise.
+// Lane state is kept as structure-of-arrays padded to a multiple of four so
+// the per-sample lane loops map directly onto SSE/NEON registers. Saw and
+// pulse edges are band-limited with PolyBLEP.
+class OscillatorBank {
+public:
+    static constexpr int maxUnisonVoices = 16;
+
+    OscillatorBank();
+
+    void setSampleRate(float sampleRate);
+    void setFrequency(float frequency);
+    void setWaveform(int waveform); // 0 = sin, 1 = saw, 2 = square/pulse, 3 = triangle
+
+    // Oscillator 2 and the extra sources
+    void setOsc2Waveform(int waveform);
+    void setOsc2Tune(float semitones, float cents);
+    void setHardSync(bool shouldSync) { hardSync = shouldSync; }
+    void setLevels(float osc1, float osc2, float sub, float noise);
+    void setNoiseSeed(juce::uint32 seed);
+
+    // 1..16 lanes, detune spread in cents across the stack, stereo spread 0..1
+    void setUnison(int numVoices, float detuneCents, float spread);
+
+    // Renders one stereo sample; a single centred lane gives left == right.
+    // Pulse widths (0..1) are per-sample inputs so they can be modulated.
+    void process(float& left, float& right, float pulseWidth1 = 0.5f, float pulseWidth2 = 0.5f);
+
+    int getNumUnisonVoices() const { return numLanes; }
+
+    // Oscillator 1 of the first lane, in cycles (0..1) and cycles per sample
+    float getPhase() const { return phases[0]; }
+    float getPhaseIncrement() const { return increments[0]; }
+    bool isStereo() const { return stereo; }
+
+private:
+    alignas(16) std::array<float, maxUnisonVoices> phases {};
+    alignas(16) std::array<float, maxUnisonVoices> increments {};
+    alignas(16) std::array<float, maxUnisonVoices> osc2Phases {};
+    alignas(16) std::array<float, maxUnisonVoices> osc2Increments {};
+    alignas(16) std::array<float, maxUnisonVoices> syncFractions {};
+    alignas(16) std::array<float, maxUnisonVoices> detuneRatios {};
+    alignas(16) std::array<float, maxUnisonVoices> leftGains {};
+    alignas(16) std::array<float, maxUnisonVoices> rightGains {};
+    alignas(16) std::array<float, maxUnisonVoices> laneOutput {};
+    alignas(16) std::array<float, maxUnisonVoices> osc2Output {};
+
+    float sampleRate = 44100.0f;
+    float currentFrequency = 0.0f;
+    int currentWaveform = 0;
+    int osc2Waveform = 1;
+    float osc2Ratio = 1.0f;
+    bool hardSync = false;
+
+    float osc1Level = 1.0f;
+    float osc2Level = 0.0f;
+    float subLevel = 0.0f;
+    float noiseLevel = 0.0f;
+
+    float subPhase = 0.0f;
+    float subIncrement = 0.0f;
+    FastRandom noise;
+
+    // Noise is generated a block at a time with FastRandom::fillBipolar, which
+    // runs its four streams side by side, and read out one sample per process()
+    static constexpr int noiseBlockSize = 64;
+    alignas(16) std::array<float, noiseBlockSize> noiseBlock {};
+    int noisePosition = noiseBlockSize;
+
+    int numLanes = 1;
+    int numProcessLanes = 4; // numLanes rounded up to a multiple of 4
+    float detune = 0.0f;
+    float stereoSpread = 0.0f;
+    bool stereo = false;
+
+    static void renderLanes(int waveform, const float* lanePhases, const float* laneIncrements,
+                            float pulseWidth, float* output, int lanes);
+    void updateIncrements();
+    void updateLaneLayout();
+};
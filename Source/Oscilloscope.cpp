@@ -0,0 +1,143 @@
+// Oscilloscope.cpp
+#include "Oscilloscope.h"
+
+Oscilloscope::Oscilloscope()
+{
+    history.resize(static_cast<size_t>(historySize));
+    setInterceptsMouseClicks(false, false);
+}
+
+void Oscilloscope::pushSamples(const float* samples, int numSamples, juce::int64 endPosition)
+{
+    if (numSamples <= 0)
+        return;
+
+    // Samples were dropped somewhere, so what's held no longer joins up
+    if (endPosition - numSamples != historyEnd)
+        numValid = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto position = endPosition - numSamples + i;
+        history[static_cast<size_t>(position % historySize)] = samples[i];
+    }
+
+    historyEnd = endPosition;
+    numValid = juce::jmin(historySize, numValid + numSamples);
+    dirty = true;
+}
+
+void Oscilloscope::setBlockInfo(const Telemetry::BlockInfo& info, int decimation)
+{
+    const Telemetry::VoiceInfo* loudest = nullptr;
+    for (int i = 0; i < info.numVoices; ++i)
+    {
+        const auto& voice = info.voices[static_cast<size_t>(i)];
+        if (voice.note >= 0 && voice.oscIncrement > 0.0f && (loudest == nullptr || voice.level > loudest->level))
+            loudest = &voice;
+    }
+
+    hasPhase = loudest != nullptr;
+    if (hasPhase)
+    {
+        period = 1.0 / (static_cast<double>(loudest->oscIncrement) * decimation);
+        zeroPhasePosition = static_cast<double>(info.streamPosition) - loudest->oscPhase * period;
+    }
+
+    dirty = true;
+}
+
+void Oscilloscope::update()
+{
+    if (!dirty)
+        return;
+
+    dirty = false;
+    rebuildTrace();
+    repaint();
+}
+
+//==============================================================================
+float Oscilloscope::sampleAt(double position) const
+{
+    const auto index = static_cast<juce::int64>(std::floor(position));
+    const float fraction = static_cast<float>(position - static_cast<double>(index));
+    const float a = history[static_cast<size_t>(index % historySize)];
+    const float b = history[static_cast<size_t>((index + 1) % historySize)];
+    return a + fraction * (b - a);
+}
+
+void Oscilloscope::findWindow(double& start, double& length) const
+{
+    const double oldest = static_cast<double>(historyEnd - numValid);
+    const double newest = static_cast<double>(historyEnd - 1);
+
+    if (hasPhase && period > 0.0 && period < historySize / 2)
+    {
+        const double cycles = juce::jmax(2.0, std::ceil(minimumSpan / period));
+        length = juce::jmin(cycles * period, historySize / 2.0);
+
+        // The latest wrap whose window is already in the history. Going back as
+        // little as possible keeps glide and vibrato from pulling the trigger off.
+        const double cyclesBack = juce::jmax(0.0, std::ceil((zeroPhasePosition + length - newest) / period));
+        start = zeroPhasePosition - cyclesBack * period;
+        if (start >= oldest)
+            return;
+    }
+
+    length = freeRunSpan;
+    start = newest - length;
+
+    for (auto position = static_cast<juce::int64>(start); position > oldest + 1 && position > start - freeRunSpan; --position)
+    {
+        if (sampleAt(static_cast<double>(position - 1)) < 0.0f && sampleAt(static_cast<double>(position)) >= 0.0f)
+        {
+            start = static_cast<double>(position);
+            return;
+        }
+    }
+}
+
+void Oscilloscope::rebuildTrace()
+{
+    trace.clear();
+
+    const int width = getWidth();
+    if (width <= 0 || numValid <= freeRunSpan + 1)
+        return;
+
+    double start = 0.0, length = 0.0;
+    findWindow(start, length);
+
+    const float centre = getHeight() * 0.5f;
+    const float scale = getHeight() * 0.45f;
+
+    for (int x = 0; x <= width; ++x)
+    {
+        const float value = juce::jlimit(-1.0f, 1.0f, sampleAt(start + length * x / width));
+        const float y = centre - value * scale;
+
+        if (x == 0)
+            trace.startNewSubPath(0.0f, y);
+        else
+            trace.lineTo(static_cast<float>(x), y);
+    }
+}
+
+void Oscilloscope::resized()
+{
+    rebuildTrace();
+}
+
+void Oscilloscope::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xff2c3e50).darker(0.3f));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.drawHorizontalLine(getHeight() / 2, 0.0f, bounds.getWidth());
+
+    g.setColour(juce::Colour(0xfff39c12));
+    g.strokePath(trace, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,52 @@
+// Oscilloscope.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "Telemetry.h"
+
+// Output waveform, a few cycles wide. While a note is sounding the trace starts where
+// oscillator 1 of the loudest voice wraps, worked out from the phase the engine
+// reports with each block, so a steady note stands still wherever the blocks fall.
+// With no voice it falls back to a rising zero crossing.
+//
+// The trace is rebuilt when new samples arrive and only stroked in paint().
+class Oscilloscope : public juce::Component
+{
+public:
+    Oscilloscope();
+
+    // Samples from Telemetry, endPosition being the stream position after the last one
+    void pushSamples(const float* samples, int numSamples, juce::int64 endPosition);
+
+    // decimation is the Telemetry setting, to convert oscillator cycles to stream samples
+    void setBlockInfo(const Telemetry::BlockInfo& info, int decimation);
+
+    // Rebuilds the trace if anything arrived since the last call
+    void update();
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr int historySize = 8192;
+    static constexpr int minimumSpan = 256;     // Stream samples; high notes show more cycles
+    static constexpr int freeRunSpan = 1024;
+
+    std::vector<float> history;                 // Ring of the most recent samples
+    juce::int64 historyEnd = 0;
+    int numValid = 0;
+
+    bool hasPhase = false;
+    double zeroPhasePosition = 0.0;             // A stream position where oscillator 1 wrapped
+    double period = 0.0;                        // In stream samples
+
+    bool dirty = false;
+    juce::Path trace;
+
+    float sampleAt(double position) const;
+    void findWindow(double& start, double& length) const;
+    void rebuildTrace();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oscilloscope)
+};
@@ -3,11 +3,41 @@
 
 //==============================================================================
 Successor37AudioProcessorEditor::Successor37AudioProcessorEditor(Successor37AudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), engineMonitor(p.getTelemetry()),
+      filterResponse(p, p.getValueTreeState(), repaintThrottler)
 {
-    // Set overall size
-    setSize(800, 600);
-    
+    // The background covers the whole editor, so nothing behind it needs painting
+    setOpaque(true);
+    addAndMakeVisible(background);
+
+    // Controls are laid out once at the design size and the whole set is scaled
+    content.setBounds(0, 0, designWidth, designHeight);
+    content.setInterceptsMouseClicks(false, true);
+    addAndMakeVisible(content);
+    content.addAndMakeVisible(engineMonitor);
+    content.addAndMakeVisible(oscilloscope);
+    content.addAndMakeVisible(spectrumAnalyzer);
+    content.addAndMakeVisible(filterResponse);
+
+    // The analyzer wants the whole band, so the stream runs at the engine's rate
+    auto& telemetry = p.getTelemetry();
+    telemetry.setDecimation(1);
+    engineMonitor.onTelemetry = [this, &telemetry](const float* samples, int numSamples, juce::int64 endPosition, const Telemetry::BlockInfo* newBlockInfo)
+    {
+        const int decimation = telemetry.getDecimation();
+        oscilloscope.pushSamples(samples, numSamples, endPosition);
+        spectrumAnalyzer.pushSamples(samples, numSamples);
+
+        if (newBlockInfo != nullptr)
+        {
+            oscilloscope.setBlockInfo(*newBlockInfo, decimation);
+            streamSampleRate = newBlockInfo->sampleRate / decimation;
+        }
+
+        oscilloscope.update();
+        spectrumAnalyzer.update(streamSampleRate);
+    };
+
     // Set custom look and feel
     setLookAndFeel(&customLookAndFeel);
     
@@ -16,15 +46,94 @@ Successor37AudioProcessorEditor::Successor37AudioProcessorEditor(Successor37Audi
     createFilterSection();
     createEnvelopeSection();
     createModulationSection();
+    layoutContent();
+
+    // Right-clicking a knob offers MIDI Learn for its parameter
+    for (auto* attachment : { oscTuneAttachment.get(), oscPWMAttachment.get(), filterCutoffAttachment.get(),
+                               filterResonanceAttachment.get(), filterDriveAttachment.get(), filterEnvAmountAttachment.get(),
+                               attackAttachment.get(), decayAttachment.get(), sustainAttachment.get(), releaseAttachment.get(),
+                               filterAttackAttachment.get(), filterDecayAttachment.get(), filterSustainAttachment.get(),
+                               filterReleaseAttachment.get(), lfo1RateAttachment.get(), lfo1AmountAttachment.get(),
+                               masterVolumeAttachment.get() })
+    {
+        attachment->getSlider().addMouseListener(this, false);
+        learnableControls.push_back(attachment);
+    }
+
+    // Resizable in proportion, from half to twice the design size
+    setResizable(true, true);
+    setResizeLimits(designWidth / 2, designHeight / 2, designWidth * 2, designHeight * 2);
+    if (auto* constrainer = getConstrainer())
+        constrainer->setFixedAspectRatio(static_cast<double>(designWidth) / designHeight);
+
+    // Set overall size
+    setSize(designWidth, designHeight);
 }
 
 Successor37AudioProcessorEditor::~Successor37AudioProcessorEditor()
 {
+    for (auto* attachment : learnableControls)
+        attachment->getSlider().removeMouseListener(this);
+
     setLookAndFeel(nullptr);
 }
 
+void Successor37AudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+    if (!e.mods.isPopupMenu())
+        return;
+
+    for (auto* attachment : learnableControls)
+    {
+        if (e.eventComponent == &attachment->getSlider())
+        {
+            showMidiLearnMenu(attachment->getParameter(), attachment->getSlider());
+            return;
+        }
+    }
+}
+
+void Successor37AudioProcessorEditor::showMidiLearnMenu(juce::RangedAudioParameter& parameter, juce::Component& target)
+{
+    auto& midiLearn = audioProcessor.getMidiLearn();
+    const int parameterIndex = midiLearn.getParameterIndex(parameter.getParameterID());
+    if (parameterIndex < 0)
+        return;
+
+    const bool learning = midiLearn.getLearningParameter() == parameterIndex;
+    juce::StringArray sources;
+    for (const auto& mapping : midiLearn.getMappings(parameterIndex))
+        sources.add(MidiLearn::describe(mapping));
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader(parameter.getName(64));
+    menu.addItem(1, learning ? "Cancel MIDI Learn" : "MIDI Learn");
+    menu.addItem(2, sources.isEmpty() ? juce::String("Forget MIDI Mapping")
+                                      : "Forget MIDI Mapping (" + sources.joinIntoString(", ") + ")",
+                 !sources.isEmpty());
+
+    // The processor outlives the menu, the editor might not
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&target),
+                       [&midiLearn, parameterIndex, learning](int result)
+                       {
+                           if (result == 1 && learning)
+                               midiLearn.cancelLearning();
+                           else if (result == 1)
+                               midiLearn.startLearning(parameterIndex);
+                           else if (result == 2)
+                               midiLearn.removeMappings(parameterIndex);
+                       });
+}
+
 //==============================================================================
-void Successor37AudioProcessorEditor::paint(juce::Graphics& g)
+Successor37AudioProcessorEditor::Background::Background()
+{
+    setOpaque(true);
+    setBufferedToImage(true);
+    setInterceptsMouseClicks(false, false);
+}
+
+void Successor37AudioProcessorEditor::Background::paint(juce::Graphics& g)
 {
     // Background gradient
     juce::ColourGradient gradient(
@@ -35,16 +144,27 @@ void Successor37AudioProcessorEditor::paint(juce::Graphics& g)
     g.setGradientFill(gradient);
     g.fillAll();
     
-    // Draw title
+    // Draw title, scaled with the editor
+    const float scale = getHeight() / static_cast<float>(designHeight);
     g.setColour(juce::Colours::white);
-    g.setFont(juce::Font(24.0f, juce::Font::bold));
-    g.drawText("SUCCESSOR 37", getLocalBounds().removeFromTop(40), 
+    g.setFont(juce::Font(24.0f * scale, juce::Font::bold));
+    g.drawText("SUCCESSOR 37", getLocalBounds().removeFromTop(juce::roundToInt(40.0f * scale)), 
                juce::Justification::centred, true);
 }
 
 void Successor37AudioProcessorEditor::resized()
 {
-    auto area = getLocalBounds().reduced(10);
+    background.setBounds(getLocalBounds());
+
+    // Knobs are drawn at the resulting physical size, so they stay sharp at any scale
+    content.setTransform(juce::AffineTransform::scale(getWidth() / static_cast<float>(designWidth)));
+}
+
+void Successor37AudioProcessorEditor::layoutContent()
+{
+    engineMonitor.setBounds(content.getWidth() - 230, 8, 220, 34);
+
+    auto area = content.getLocalBounds().reduced(10);
     area.removeFromTop(50); // Title space
     
     const int sectionHeight = area.getHeight() / 2;
@@ -81,31 +201,31 @@ void Successor37AudioProcessorEditor::createOscillatorSection()
     oscWaveformSelector.addItem("Square", 3);
     oscWaveformSelector.addItem("Triangle", 4);
     oscWaveformSelector.setSelectedId(2);
-    addAndMakeVisible(oscWaveformSelector);
+    content.addAndMakeVisible(oscWaveformSelector);
     oscWaveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getValueTreeState(), "oscWaveform", oscWaveformSelector);
     
     // Oscillator tune slider
     oscTuneSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     oscTuneSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(oscTuneSlider);
-    oscTuneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "oscTune", oscTuneSlider);
+    content.addAndMakeVisible(oscTuneSlider);
+    oscTuneAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("oscTune"), oscTuneSlider, repaintThrottler);
     
     oscTuneLabel.setText("Tune", juce::dontSendNotification);
     oscTuneLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(oscTuneLabel);
+    content.addAndMakeVisible(oscTuneLabel);
     
     // PWM slider
     oscPWMSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     oscPWMSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(oscPWMSlider);
-    oscPWMAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "oscPWM", oscPWMSlider);
+    content.addAndMakeVisible(oscPWMSlider);
+    oscPWMAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("oscPWM"), oscPWMSlider, repaintThrottler);
     
     oscPWMLabel.setText("PWM", juce::dontSendNotification);
     oscPWMLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(oscPWMLabel);
+    content.addAndMakeVisible(oscPWMLabel);
 }
 
 void Successor37AudioProcessorEditor::createFilterSection()
@@ -113,46 +233,46 @@ void Successor37AudioProcessorEditor::createFilterSection()
     // Filter cutoff
     filterCutoffSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     filterCutoffSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(filterCutoffSlider);
-    filterCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterCutoff", filterCutoffSlider);
+    content.addAndMakeVisible(filterCutoffSlider);
+    filterCutoffAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterCutoff"), filterCutoffSlider, repaintThrottler);
     
     filterCutoffLabel.setText("Cutoff", juce::dontSendNotification);
     filterCutoffLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(filterCutoffLabel);
+    content.addAndMakeVisible(filterCutoffLabel);
     
     // Filter resonance
     filterResonanceSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     filterResonanceSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(filterResonanceSlider);
-    filterResonanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterResonance", filterResonanceSlider);
+    content.addAndMakeVisible(filterResonanceSlider);
+    filterResonanceAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterResonance"), filterResonanceSlider, repaintThrottler);
     
     filterResonanceLabel.setText("Resonance", juce::dontSendNotification);
     filterResonanceLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(filterResonanceLabel);
+    content.addAndMakeVisible(filterResonanceLabel);
     
     // Filter drive
     filterDriveSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     filterDriveSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(filterDriveSlider);
-    filterDriveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterDrive", filterDriveSlider);
+    content.addAndMakeVisible(filterDriveSlider);
+    filterDriveAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterDrive"), filterDriveSlider, repaintThrottler);
     
     filterDriveLabel.setText("Drive", juce::dontSendNotification);
     filterDriveLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(filterDriveLabel);
+    content.addAndMakeVisible(filterDriveLabel);
     
     // Filter envelope amount
     filterEnvAmountSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     filterEnvAmountSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(filterEnvAmountSlider);
-    filterEnvAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterEnvAmount", filterEnvAmountSlider);
+    content.addAndMakeVisible(filterEnvAmountSlider);
+    filterEnvAmountAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterEnvAmount"), filterEnvAmountSlider, repaintThrottler);
     
     filterEnvAmountLabel.setText("Env Amount", juce::dontSendNotification);
     filterEnvAmountLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(filterEnvAmountLabel);
+    content.addAndMakeVisible(filterEnvAmountLabel);
 }
 
 void Successor37AudioProcessorEditor::createEnvelopeSection()
@@ -163,45 +283,45 @@ void Successor37AudioProcessorEditor::createEnvelopeSection()
     {
         slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
         slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
-        addAndMakeVisible(slider);
+        content.addAndMakeVisible(slider);
         
         label.setText(labelText, juce::dontSendNotification);
         label.setJustificationType(juce::Justification::centred);
-        addAndMakeVisible(label);
+        content.addAndMakeVisible(label);
     };
     
     createAmpSlider(attackSlider, attackLabel, "A", "ampAttack");
-    attackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "ampAttack", attackSlider);
+    attackAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("ampAttack"), attackSlider, repaintThrottler);
     
     createAmpSlider(decaySlider, decayLabel, "D", "ampDecay");
-    decayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "ampDecay", decaySlider);
+    decayAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("ampDecay"), decaySlider, repaintThrottler);
     
     createAmpSlider(sustainSlider, sustainLabel, "S", "ampSustain");
-    sustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "ampSustain", sustainSlider);
+    sustainAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("ampSustain"), sustainSlider, repaintThrottler);
     
     createAmpSlider(releaseSlider, releaseLabel, "R", "ampRelease");
-    releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "ampRelease", releaseSlider);
+    releaseAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("ampRelease"), releaseSlider, repaintThrottler);
     
     // Filter envelope
     createAmpSlider(filterAttackSlider, filterAttackLabel, "A", "filterAttack");
-    filterAttackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterAttack", filterAttackSlider);
+    filterAttackAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterAttack"), filterAttackSlider, repaintThrottler);
     
     createAmpSlider(filterDecaySlider, filterDecayLabel, "D", "filterDecay");
-    filterDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterDecay", filterDecaySlider);
+    filterDecayAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterDecay"), filterDecaySlider, repaintThrottler);
     
     createAmpSlider(filterSustainSlider, filterSustainLabel, "S", "filterSustain");
-    filterSustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterSustain", filterSustainSlider);
+    filterSustainAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterSustain"), filterSustainSlider, repaintThrottler);
     
     createAmpSlider(filterReleaseSlider, filterReleaseLabel, "R", "filterRelease");
-    filterReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "filterRelease", filterReleaseSlider);
+    filterReleaseAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("filterRelease"), filterReleaseSlider, repaintThrottler);
 }
 
 void Successor37AudioProcessorEditor::createModulationSection()
@@ -209,41 +329,42 @@ void Successor37AudioProcessorEditor::createModulationSection()
     // LFO Rate
     lfo1RateSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     lfo1RateSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(lfo1RateSlider);
-    lfo1RateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "lfo1Rate", lfo1RateSlider);
+    content.addAndMakeVisible(lfo1RateSlider);
+    lfo1RateAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("lfo1Rate"), lfo1RateSlider, repaintThrottler);
     
     lfo1RateLabel.setText("LFO Rate", juce::dontSendNotification);
     lfo1RateLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(lfo1RateLabel);
+    content.addAndMakeVisible(lfo1RateLabel);
     
     // LFO Amount (to filter)
     lfo1AmountSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     lfo1AmountSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(lfo1AmountSlider);
-    lfo1AmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "lfo1ToFilter", lfo1AmountSlider);
+    content.addAndMakeVisible(lfo1AmountSlider);
+    lfo1AmountAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("lfo1ToFilter"), lfo1AmountSlider, repaintThrottler);
     
     lfo1AmountLabel.setText("LFO > Filter", juce::dontSendNotification);
     lfo1AmountLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(lfo1AmountLabel);
+    content.addAndMakeVisible(lfo1AmountLabel);
     
     // Master volume
     masterVolumeSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     masterVolumeSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
-    addAndMakeVisible(masterVolumeSlider);
-    masterVolumeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getValueTreeState(), "masterVolume", masterVolumeSlider);
+    content.addAndMakeVisible(masterVolumeSlider);
+    masterVolumeAttachment = std::make_unique<ThrottledSliderAttachment>(
+        *audioProcessor.getValueTreeState().getParameter("masterVolume"), masterVolumeSlider, repaintThrottler);
     
     masterVolumeLabel.setText("Volume", juce::dontSendNotification);
     masterVolumeLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(masterVolumeLabel);
+    content.addAndMakeVisible(masterVolumeLabel);
 }
 
 //==============================================================================
 void Successor37AudioProcessorEditor::layoutOscillatorSection(juce::Rectangle<int> area)
 {
     area.reduce(10, 10);
+    oscilloscope.setBounds(area.removeFromRight(160).removeFromTop(160).reduced(5));
     
     auto row1 = area.removeFromTop(80);
     oscWaveformSelector.setBounds(row1.removeFromLeft(120).reduced(5));
@@ -258,6 +379,7 @@ void Successor37AudioProcessorEditor::layoutOscillatorSection(juce::Rectangle<in
 void Successor37AudioProcessorEditor::layoutFilterSection(juce::Rectangle<int> area)
 {
     area.reduce(10, 10);
+    filterResponse.setBounds(area.removeFromRight(160).removeFromTop(160).reduced(5));
     
     auto row1 = area.removeFromTop(80);
     filterCutoffSlider.setBounds(row1.removeFromLeft(80).reduced(5));
@@ -310,6 +432,7 @@ void Successor37AudioProcessorEditor::layoutEnvelopeSection(juce::Rectangle<int>
 void Successor37AudioProcessorEditor::layoutModulationSection(juce::Rectangle<int> area)
 {
     area.reduce(10, 10);
+    spectrumAnalyzer.setBounds(area.removeFromRight(160).removeFromTop(160).reduced(5));
     
     auto row1 = area.removeFromTop(80);
     lfo1RateSlider.setBounds(row1.removeFromLeft(80).reduced(5));
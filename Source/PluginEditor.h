@@ -4,6 +4,11 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "CustomLookAndFeel.h"
+#include "RepaintThrottler.h"
+#include "EngineMonitor.h"
+#include "Oscilloscope.h"
+#include "SpectrumAnalyzer.h"
+#include "FilterResponseView.h"
 
 class Successor37AudioProcessorEditor : public juce::AudioProcessorEditor
 {
@@ -11,14 +16,46 @@ public:
     Successor37AudioProcessorEditor(Successor37AudioProcessor&);
     ~Successor37AudioProcessorEditor() override;
 
-    void paint(juce::Graphics&) override;
     void resized() override;
+    void mouseDown(const juce::MouseEvent&) override;
+
+    // Parameter changes reach the controls through this, also used by the GUI benchmark
+    RepaintThrottler& getRepaintThrottler() { return repaintThrottler; }
 
 private:
     Successor37AudioProcessor& audioProcessor;
     
     // Custom look and feel
     CustomLookAndFeel customLookAndFeel;
+    RepaintThrottler repaintThrottler;
+    
+    // The layout is designed at this size; the editor resizes in proportion
+    static constexpr int designWidth = 800;
+    static constexpr int designHeight = 600;
+
+    // Gradient and title. It never changes, so it's kept as an image and only
+    // re-rendered when the size or display scale changes.
+    class Background : public juce::Component
+    {
+    public:
+        Background();
+        void paint(juce::Graphics&) override;
+    };
+    Background background;
+
+    // Holds every control at the design size, scaled to the editor's size
+    juce::Component content;
+
+    // Voice, LFO, level and CPU readout, fed by the processor's Telemetry
+    EngineMonitor engineMonitor;
+
+    // Share the monitor's sample stream and timer
+    Oscilloscope oscilloscope;
+    SpectrumAnalyzer spectrumAnalyzer;
+    double streamSampleRate = 0.0;
+
+    // Follows the filter parameters through the throttler
+    FilterResponseView filterResponse;
     
     // Oscillator Section
     juce::ComboBox oscWaveformSelector;
@@ -28,8 +65,8 @@ private:
     juce::Label oscPWMLabel;
     
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oscWaveformAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> oscTuneAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> oscPWMAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> oscTuneAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> oscPWMAttachment;
     
     // Filter Section
     juce::Slider filterCutoffSlider;
@@ -41,10 +78,10 @@ private:
     juce::Label filterDriveLabel;
     juce::Label filterEnvAmountLabel;
     
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterCutoffAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterResonanceAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterDriveAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterEnvAmountAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterCutoffAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterResonanceAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterDriveAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterEnvAmountAttachment;
     
     // Amplitude Envelope Section
     juce::Slider attackSlider;
@@ -56,10 +93,10 @@ private:
     juce::Label sustainLabel;
     juce::Label releaseLabel;
     
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attackAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> decayAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sustainAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> attackAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> decayAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> sustainAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> releaseAttachment;
     
     // Filter Envelope Section
     juce::Slider filterAttackSlider;
@@ -71,10 +108,10 @@ private:
     juce::Label filterSustainLabel;
     juce::Label filterReleaseLabel;
     
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterAttackAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterDecayAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterSustainAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterReleaseAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterAttackAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterDecayAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterSustainAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> filterReleaseAttachment;
     
     // LFO and Modulation Section
     juce::Slider lfo1RateSlider;
@@ -82,13 +119,17 @@ private:
     juce::Label lfo1RateLabel;
     juce::Label lfo1AmountLabel;
     
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lfo1RateAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lfo1AmountAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> lfo1RateAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> lfo1AmountAttachment;
     
     // Master Volume
     juce::Slider masterVolumeSlider;
     juce::Label masterVolumeLabel;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> masterVolumeAttachment;
+    std::unique_ptr<ThrottledSliderAttachment> masterVolumeAttachment;
+    
+    // Knobs that offer MIDI Learn on right-click
+    std::vector<ThrottledSliderAttachment*> learnableControls;
+    void showMidiLearnMenu(juce::RangedAudioParameter& parameter, juce::Component& target);
     
     // Helper methods for creating UI
     void createOscillatorSection();
@@ -97,6 +138,7 @@ private:
     void createModulationSection();
     
     // Layout helpers
+    void layoutContent();
     void layoutOscillatorSection(juce::Rectangle<int> area);
     void layoutFilterSection(juce::Rectangle<int> area);
     void layoutEnvelopeSection(juce::Rectangle<int> area);
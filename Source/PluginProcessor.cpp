@@ -12,6 +12,15 @@ Successor37AudioProcessor::Successor37AudioProcessor()
     oscWaveformParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("oscWaveform"));
     oscTuneParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("oscTune"));
     oscPWMParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("oscPWM"));
+    osc2WaveformParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("osc2Waveform"));
+    osc2TuneParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("osc2Tune"));
+    osc2FineParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("osc2Fine"));
+    osc2PWMParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("osc2PWM"));
+    hardSyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("hardSync"));
+    osc1LevelParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("osc1Level"));
+    osc2LevelParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("osc2Level"));
+    subLevelParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("subLevel"));
+    noiseLevelParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("noiseLevel"));
     filterCutoffParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("filterCutoff"));
     filterResonanceParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("filterResonance"));
     filterDriveParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("filterDrive"));
@@ -25,6 +34,50 @@ Successor37AudioProcessor::Successor37AudioProcessor()
     filterSustainParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("filterSustain"));
     filterReleaseParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("filterRelease"));
     masterVolumeParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("masterVolume"));
+    notePriorityParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("notePriority"));
+    voiceStealModeParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("voiceStealMode"));
+    voiceModeParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("voiceMode"));
+    glideTimeParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("glideTime"));
+    unisonVoicesParam = dynamic_cast<juce::AudioParameterInt*>(parameters.getParameter("unisonVoices"));
+    unisonDetuneParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("unisonDetune"));
+    unisonSpreadParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("unisonSpread"));
+    lfo1RateParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo1Rate"));
+    lfo1WaveformParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("lfo1Waveform"));
+    lfo1SyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("lfo1Sync"));
+    lfo1DivisionParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("lfo1Division"));
+    lfo1KeySyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("lfo1KeySync"));
+    lfo1ToFilterParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo1ToFilter"));
+    lfo1ToPitchParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo1ToPitch"));
+    lfo1ToPWMParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo1ToPWM"));
+    lfo2RateParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo2Rate"));
+    lfo2WaveformParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("lfo2Waveform"));
+    lfo2SyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("lfo2Sync"));
+    lfo2DivisionParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("lfo2Division"));
+    lfo2KeySyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("lfo2KeySync"));
+    lfo2ToFilterParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo2ToFilter"));
+    lfo2ToPitchParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lfo2ToPitch"));
+    modWheelToFilterParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("modWheelToFilter"));
+    velocityToFilterParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("velocityToFilter"));
+    velocityToAmpParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("velocityToAmp"));
+    morphParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("morph"));
+    morphEnabledParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("morphEnabled"));
+    arpEnabledParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("arpEnabled"));
+    arpPatternParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("arpPattern"));
+    arpRateParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("arpRate"));
+    arpSyncParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("arpSync"));
+    arpDivisionParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("arpDivision"));
+    arpSwingParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("arpSwing"));
+    arpGateParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("arpGate"));
+    arpOctavesParam = dynamic_cast<juce::AudioParameterInt*>(parameters.getParameter("arpOctaves"));
+    seqEnabledParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("seqEnabled"));
+    seqRecordParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("seqRecord"));
+    seqDivisionParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("seqDivision"));
+    seqSwingParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("seqSwing"));
+    seqToFilterParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("seqToFilter"));
+    seqToPitchParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("seqToPitch"));
+    midiOutputParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("midiOutput"));
+    multiCoreRenderingParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("multiCoreRendering"));
+    multiCoreThresholdParam = dynamic_cast<juce::AudioParameterInt*>(parameters.getParameter("multiCoreThreshold"));
 
     // Create and add the synth sound
     synthSound = std::make_unique<SynthSound>();
@@ -34,6 +87,26 @@ Successor37AudioProcessor::Successor37AudioProcessor()
     for (int i = 0; i < 8; ++i) {
         synth.addVoice(new SynthVoice());
     }
+    synth.initialiseVoices();
+
+    // Preset system. Created once here (not in prepareToPlay) so its loader thread and
+    // any pointer the editor holds outlive a change of sample rate or block size.
+    presetManager = std::make_unique<PresetManager>(parameters);
+    midiLearn = std::make_unique<MidiLearn>(presetManager->getParameterList());
+
+    // Per-parameter tables for the voice values and preset morphing, indexed like
+    // getParameters() (every parameter here is a ranged APVTS one)
+    const auto& parameterList = presetManager->getParameterList();
+    jassert(parameterList.size() == getParameters().size());
+
+    voiceValues.resize(static_cast<size_t>(parameterList.size()));
+    presetValues.resize(voiceValues.size());
+    morphTargetA.resize(voiceValues.size());
+    morphTargetB.resize(voiceValues.size());
+    for (auto* parameter : parameterList)
+        discreteParameters.push_back(parameter->isDiscrete() || parameter->isBoolean());
+
+    updateVoiceValues();
 }
 
 Successor37AudioProcessor::~Successor37AudioProcessor()
@@ -53,7 +126,8 @@ bool Successor37AudioProcessor::acceptsMidi() const
 
 bool Successor37AudioProcessor::producesMidi() const
 {
-    return false;
+    // Only sends anything with the MIDI Output parameter on
+    return true;
 }
 
 bool Successor37AudioProcessor::isMidiEffect() const
@@ -104,19 +178,43 @@ void Successor37AudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     
     synth.setCurrentPlaybackSampleRate(sampleRate);
 
+    // Worker threads for multi-core rendering, one per spare core
+    const int numThreads = maxThreads > 0 ? juce::jmin(maxThreads, juce::SystemStats::getNumCpus())
+                                          : juce::SystemStats::getNumCpus();
+    const int numWorkers = juce::jmin(numThreads - 1, synth.getNumVoices() - 1);
+    scheduler.prepare(numWorkers);
+    synth.prepareParallelRendering(scheduler, samplesPerBlock, getTotalNumOutputChannels());
+
     // Prepare effects
     delay.prepare(sampleRate, samplesPerBlock);
     chorus.prepare(sampleRate, samplesPerBlock);
     arpeggiator.prepare(sampleRate);
+    stepSequencer.prepare(sampleRate);
+    processedMidi.ensureSize(2048);
+    generatedMidi.ensureSize(2048);
 
-    // Initialize preset manager
-    presetManager = std::make_unique<PresetManager>(parameters);
+    samplesUntilParameterUpdate = 0;
+
+    presetFadeGain.reset(sampleRate, presetFadeSeconds);
+    presetFadeGain.setCurrentAndTargetValue(1.0f);
+    presetManager->setAudioRunning(true);
+}
+
+void Successor37AudioProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+
+    // Pick up the current parameters on the first block in the new mode
+    samplesUntilParameterUpdate = 0;
 }
 
 void Successor37AudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    presetManager->setAudioRunning(false);
+    synth.releaseParallelRendering();
+    scheduler.release();
 }
 
 bool Successor37AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -131,6 +229,7 @@ bool Successor37AudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
 void Successor37AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const juce::int64 blockStartTicks = telemetry.isActive() ? juce::Time::getHighResolutionTicks() : 0;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -138,22 +237,174 @@ void Successor37AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Pending presets land here, before the parameters are read, so every voice
+    // parameter switches in the same block. A crossfading one waits for the output to
+    // dip first.
+    const bool fadeOutForPreset = presetManager->isPresetPending()
+                               && presetManager->pendingPresetWantsCrossfade()
+                               && !isNonRealtime();
+    if (!fadeOutForPreset || presetFadeGain.getCurrentValue() <= 0.0f)
+    {
+        if (presetManager->takePendingPreset(presetValues, presetGeneration))
+        {
+            followingPreset = true;
+            samplesUntilParameterUpdate = 0;
+        }
+        presetFadeGain.setTargetValue(1.0f);
+    }
+    else
+    {
+        presetFadeGain.setTargetValue(0.0f);
+    }
+
+    // Mapped controllers move their parameters before anything reads them
+    midiLearn->process(midiMessages);
+
     // Update host info
     updateHostInfo();
 
-    // Update voice parameters
-    updateParameters();
+    // Update voice parameters. Offline bounces refresh them at a coarser control rate,
+    // so a tiny host block size doesn't pay for a full parameter push every block.
+    const bool offline = isNonRealtime();
+    if (!offline || samplesUntilParameterUpdate <= 0)
+    {
+        updateParameters();
+        samplesUntilParameterUpdate = offlineControlInterval;
+    }
+    samplesUntilParameterUpdate -= buffer.getNumSamples();
+
+    // The sequencer plays alongside the arpeggiator and records from the notes coming in
+    processedMidi.clear();
+    stepSequencer.process(midiMessages, generatedMidi, buffer.getNumSamples());
+    arpeggiator.process(midiMessages, generatedMidi, buffer.getNumSamples());
+    processedMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
+    processedMidi.addEvents(generatedMidi, 0, buffer.getNumSamples(), 0);
 
-    // Process arpeggiator
-    juce::MidiBuffer processedMidi;
-    arpeggiator.process(midiMessages, processedMidi, buffer.getNumSamples());
+    updateVoiceTransport();
 
     // Process synth
     synth.renderNextBlock(buffer, processedMidi, 0, buffer.getNumSamples());
 
+    // The generated notes go to the host, so other instruments can follow the
+    // arpeggiator and sequencer without generating them again. Input is never echoed,
+    // and with both off only the note-offs ending their last notes go out.
+    midiMessages.clear();
+    sendMidiOutput(midiMessages, buffer.getNumSamples());
+    generatedMidi.clear();
+
     // Process effects
-    delay.process(buffer);
-    chorus.process(buffer);
+    processEffects(buffer);
+
+    if (presetFadeGain.isSmoothing() || presetFadeGain.getCurrentValue() < 1.0f)
+        presetFadeGain.applyGain(buffer, buffer.getNumSamples());
+
+    // Only while an editor is listening
+    if (telemetry.isActive())
+        pushTelemetry(buffer, blockStartTicks);
+}
+
+void Successor37AudioProcessor::sendMidiOutput(juce::MidiBuffer& midiMessages, int numSamples)
+{
+    const bool enabled = midiOutputParam->get();
+    if (enabled)
+    {
+        midiMessages.addEvents(generatedMidi, 0, numSamples, 0);
+
+        // Remember what's sounding downstream, so switching off can end it
+        for (const auto metadata : generatedMidi)
+        {
+            const auto message = metadata.getMessage();
+            if (!message.isNoteOnOrOff())
+                continue;
+
+            auto& notes = outputNotesOn[static_cast<size_t>(message.getChannel() - 1)];
+            const int note = message.getNoteNumber();
+            const auto bit = juce::uint64(1) << (note & 63);
+            if (message.isNoteOn())
+                notes[static_cast<size_t>(note >> 6)] |= bit;
+            else
+                notes[static_cast<size_t>(note >> 6)] &= ~bit;
+        }
+    }
+    else if (midiOutputWasEnabled)
+    {
+        // Switched off: the host has note-ons whose note-offs would never come
+        for (int channel = 0; channel < 16; ++channel)
+        {
+            auto& notes = outputNotesOn[static_cast<size_t>(channel)];
+            for (int note = 0; note < 128; ++note)
+                if ((notes[static_cast<size_t>(note >> 6)] >> (note & 63)) & 1)
+                    midiMessages.addEvent(juce::MidiMessage::noteOff(channel + 1, note), 0);
+            notes = {};
+        }
+    }
+
+    midiOutputWasEnabled = enabled;
+}
+
+void Successor37AudioProcessor::processEffects(juce::AudioBuffer<float>& buffer)
+{
+    // Each channel runs delay then chorus on its own, the meter (only while an editor
+    // is listening) waits for both
+    effectsGraph.clear();
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    std::array<int, 2> chorusTasks { -1, -1 };
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const int delayTask = effectsGraph.addTask([this, &buffer, channel] { delay.processChannel(buffer, channel); });
+        chorusTasks[static_cast<size_t>(channel)] = effectsGraph.addTask([this, &buffer, channel] { chorus.processChannel(buffer, channel); });
+        effectsGraph.addDependency(chorusTasks[static_cast<size_t>(channel)], delayTask);
+    }
+
+    if (telemetry.isActive())
+    {
+        const int meterTask = effectsGraph.addTask([this, &buffer] { updateOutputPeaks(buffer); });
+        for (int channel = 0; channel < numChannels; ++channel)
+            effectsGraph.addDependency(meterTask, chorusTasks[static_cast<size_t>(channel)]);
+    }
+
+    scheduler.run(effectsGraph);
+}
+
+void Successor37AudioProcessor::updateOutputPeaks(const juce::AudioBuffer<float>& buffer)
+{
+    for (int channel = 0; channel < juce::jmin(buffer.getNumChannels(), 2); ++channel)
+        outputPeaks[static_cast<size_t>(channel)].store(buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+}
+
+void Successor37AudioProcessor::pushTelemetry(const juce::AudioBuffer<float>& buffer, juce::int64 blockStartTicks)
+{
+    telemetry.pushSamples(buffer);
+
+    Telemetry::BlockInfo info;
+    info.numVoices = juce::jmin(synth.getNumVoices(), Telemetry::maxVoices);
+    for (int i = 0; i < info.numVoices; ++i)
+    {
+        auto* voice = synth.getSynthVoice(i);
+        if (voice == nullptr || !voice->isActive())
+            continue;
+
+        auto& voiceInfo = info.voices[static_cast<size_t>(i)];
+        voiceInfo.note = voice->getCurrentNote();
+        voiceInfo.level = voice->getAmpEnvelopeLevel();
+        voiceInfo.lfo1 = voice->getLFO1Value();
+        voiceInfo.lfo2 = voice->getLFO2Value();
+        voiceInfo.oscPhase = voice->getOscillatorPhase();
+        voiceInfo.oscIncrement = voice->getOscillatorPhaseIncrement();
+    }
+
+    info.outputPeaks = { outputPeaks[0].load(), outputPeaks[1].load() };
+    info.numSamples = buffer.getNumSamples();
+    info.sampleRate = getSampleRate();
+
+    // The block started before the consumer attached if there's no start time
+    const double blockSeconds = buffer.getNumSamples() / getSampleRate();
+    if (blockStartTicks != 0 && blockSeconds > 0.0)
+        info.cpuLoad = static_cast<float>(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks) / blockSeconds);
+
+    telemetry.pushBlockInfo(info);
 }
 
 //==============================================================================
@@ -168,82 +419,203 @@ void Successor37AudioProcessor::updateHostInfo()
             if (auto bpm = positionInfo->getBpm())
                 currentBPM = *bpm;
             
+            if (auto ppq = positionInfo->getPpqPosition())
+                currentPPQ = *ppq;
+
             isPlaying = positionInfo->getIsPlaying();
 
             // Update effects with host info
             delay.setHostInfo(currentBPM, isPlaying);
-            arpeggiator.setHostInfo(currentBPM, isPlaying);
+            arpeggiator.setTransportPosition(currentBPM, currentPPQ, isPlaying);
+            stepSequencer.setTransportPosition(currentBPM, currentPPQ, isPlaying);
+        }
+    }
+}
+
+void Successor37AudioProcessor::updateVoiceTransport()
+{
+    // Tempo-synced LFOs take their rate and phase from the host once per block, and
+    // the sequencer's modulation lane steps with it
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+        {
+            voice->setTransportPosition(currentBPM, currentPPQ, isPlaying);
+            voice->setSequencerModulation(stepSequencer.getModulationValue());
         }
     }
 }
 
 void Successor37AudioProcessor::updateParameters()
 {
+    // Voice allocation
+    if (notePriorityParam)
+        synth.setNotePriority(static_cast<NotePriority>(notePriorityParam->getIndex()));
+    if (voiceStealModeParam)
+        synth.setStealMode(voiceStealModeParam->getIndex());
+    if (voiceModeParam)
+        synth.setVoiceMode(voiceModeParam->getIndex());
+
+    // Arpeggiator
+    arpeggiator.setEnabled(arpEnabledParam->get());
+    arpeggiator.setPattern(static_cast<Arpeggiator::Pattern>(arpPatternParam->getIndex()));
+    arpeggiator.setRate(arpRateParam->get());
+    arpeggiator.setSyncToHost(arpSyncParam->get());
+    arpeggiator.setDivision(static_cast<Arpeggiator::Division>(arpDivisionParam->getIndex()));
+    arpeggiator.setSwing(arpSwingParam->get());
+    arpeggiator.setGate(arpGateParam->get());
+    arpeggiator.setOctaves(arpOctavesParam->get());
+
+    // Step sequencer
+    stepSequencer.setEnabled(seqEnabledParam->get());
+    stepSequencer.setRecording(seqRecordParam->get());
+    stepSequencer.setDivision(static_cast<Arpeggiator::Division>(seqDivisionParam->getIndex()));
+    stepSequencer.setSwing(seqSwingParam->get());
+
+    // Offline bounces always use every core
+    const bool offline = isNonRealtime();
+    const bool multiCore = offline || multiCoreRenderingParam->get();
+    const int multiCoreThreshold = offline ? 2 : multiCoreThresholdParam->get();
+    synth.setParallelRendering(multiCore, multiCoreThreshold);
+    scheduler.setDeterministic(!multiCore);
+
+    // Sound parameters go through the per-block voice values, which may be a morph
+    updateVoiceValues();
+    auto value = [this](const juce::RangedAudioParameter* parameter) { return getVoiceValue(parameter); };
+    auto index = [this](const juce::RangedAudioParameter* parameter) { return juce::roundToInt(getVoiceValue(parameter)); };
+    auto isOn = [this](const juce::RangedAudioParameter* parameter) { return getVoiceValue(parameter) > 0.5f; };
+
     for (int i = 0; i < synth.getNumVoices(); ++i)
     {
         if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
         {
             // Oscillator parameters
             if (oscWaveformParam)
-                voice->setOscillatorWaveform(oscWaveformParam->getIndex());
+                voice->setOscillatorWaveform(index(oscWaveformParam));
             if (oscTuneParam)
-                voice->setOscillatorTune(oscTuneParam->get());
+                voice->setOscillatorTune(value(oscTuneParam));
             if (oscPWMParam)
-                voice->setOscillatorPWM(oscPWMParam->get());
+                voice->setOscillatorPWM(value(oscPWMParam));
+            if (osc2WaveformParam)
+                voice->setOscillator2Waveform(index(osc2WaveformParam));
+            if (osc2TuneParam && osc2FineParam)
+                voice->setOscillator2Tune(value(osc2TuneParam), value(osc2FineParam));
+            if (osc2PWMParam)
+                voice->setOscillator2PWM(value(osc2PWMParam));
+            if (hardSyncParam)
+                voice->setHardSync(isOn(hardSyncParam));
+            if (osc1LevelParam && osc2LevelParam && subLevelParam && noiseLevelParam)
+                voice->setOscillatorLevels(value(osc1LevelParam), value(osc2LevelParam),
+                                           value(subLevelParam), value(noiseLevelParam));
+            if (glideTimeParam)
+                voice->setGlideTime(value(glideTimeParam));
+            if (unisonVoicesParam && unisonDetuneParam && unisonSpreadParam)
+                voice->setUnison(index(unisonVoicesParam), value(unisonDetuneParam), value(unisonSpreadParam));
 
             // Filter parameters
             if (filterCutoffParam)
-                voice->setFilterCutoff(filterCutoffParam->get());
+                voice->setFilterCutoff(value(filterCutoffParam));
             if (filterResonanceParam)
-                voice->setFilterResonance(filterResonanceParam->get());
+                voice->setFilterResonance(value(filterResonanceParam));
             if (filterDriveParam)
-                voice->setFilterDrive(filterDriveParam->get());
+                voice->setFilterDrive(value(filterDriveParam));
             if (filterEnvAmountParam)
-                voice->setFilterEnvAmount(filterEnvAmountParam->get());
+                voice->setFilterEnvAmount(value(filterEnvAmountParam));
 
             // Amplitude envelope parameters
             if (ampAttackParam)
-                voice->setAmpAttackTime(ampAttackParam->get());
+                voice->setAmpAttackTime(value(ampAttackParam));
             if (ampDecayParam)
-                voice->setAmpDecayTime(ampDecayParam->get());
+                voice->setAmpDecayTime(value(ampDecayParam));
             if (ampSustainParam)
-                voice->setAmpSustainLevel(ampSustainParam->get());
+                voice->setAmpSustainLevel(value(ampSustainParam));
             if (ampReleaseParam)
-                voice->setAmpReleaseTime(ampReleaseParam->get());
+                voice->setAmpReleaseTime(value(ampReleaseParam));
 
             // Filter envelope parameters
             if (filterAttackParam)
-                voice->setFilterAttackTime(filterAttackParam->get());
+                voice->setFilterAttackTime(value(filterAttackParam));
             if (filterDecayParam)
-                voice->setFilterDecayTime(filterDecayParam->get());
+                voice->setFilterDecayTime(value(filterDecayParam));
             if (filterSustainParam)
-                voice->setFilterSustainLevel(filterSustainParam->get());
+                voice->setFilterSustainLevel(value(filterSustainParam));
             if (filterReleaseParam)
-                voice->setFilterReleaseTime(filterReleaseParam->get());
+                voice->setFilterReleaseTime(value(filterReleaseParam));
 
             // LFO parameters
-            voice->setLFO1Rate(*parameters.getRawParameterValue("lfo1Rate"));
-            voice->setLFO1Waveform(static_cast<int>(*parameters.getRawParameterValue("lfo1Waveform")));
-            voice->setLFO1ToFilterAmount(*parameters.getRawParameterValue("lfo1ToFilter"));
-            voice->setLFO1ToPitchAmount(*parameters.getRawParameterValue("lfo1ToPitch"));
-
-            voice->setLFO2Rate(*parameters.getRawParameterValue("lfo2Rate"));
-            voice->setLFO2Waveform(static_cast<int>(*parameters.getRawParameterValue("lfo2Waveform")));
-            voice->setLFO2ToFilterAmount(*parameters.getRawParameterValue("lfo2ToFilter"));
-            voice->setLFO2ToPitchAmount(*parameters.getRawParameterValue("lfo2ToPitch"));
+            voice->setLFO1Rate(value(lfo1RateParam));
+            voice->setLFO1Waveform(index(lfo1WaveformParam));
+            voice->setLFO1ToFilterAmount(value(lfo1ToFilterParam));
+            voice->setLFO1ToPitchAmount(value(lfo1ToPitchParam));
+            voice->setLFO1ToPWMAmount(value(lfo1ToPWMParam));
+            voice->setLFO1TempoSync(isOn(lfo1SyncParam), index(lfo1DivisionParam));
+            voice->setLFO1KeySync(isOn(lfo1KeySyncParam));
+
+            voice->setLFO2Rate(value(lfo2RateParam));
+            voice->setLFO2Waveform(index(lfo2WaveformParam));
+            voice->setLFO2ToFilterAmount(value(lfo2ToFilterParam));
+            voice->setLFO2ToPitchAmount(value(lfo2ToPitchParam));
+            voice->setLFO2TempoSync(isOn(lfo2SyncParam), index(lfo2DivisionParam));
+            voice->setLFO2KeySync(isOn(lfo2KeySyncParam));
 
             // Modulation parameters
-            voice->setModWheelToFilterAmount(*parameters.getRawParameterValue("modWheelToFilter"));
-            voice->setVelocityToFilterAmount(*parameters.getRawParameterValue("velocityToFilter"));
-            voice->setVelocityToAmpAmount(*parameters.getRawParameterValue("velocityToAmp"));
+            voice->setModWheelToFilterAmount(value(modWheelToFilterParam));
+            voice->setVelocityToFilterAmount(value(velocityToFilterParam));
+            voice->setVelocityToAmpAmount(value(velocityToAmpParam));
+            voice->setSequencerToFilterAmount(value(seqToFilterParam));
+            voice->setSequencerToPitchAmount(value(seqToPitchParam));
 
             // Master volume
             if (masterVolumeParam)
-                voice->setMasterVolume(masterVolumeParam->get());
+                voice->setMasterVolume(value(masterVolumeParam));
         }
     }
 }
 
+void Successor37AudioProcessor::updateVoiceValues()
+{
+    // The message thread sets the parameters of a new preset on its own schedule, so
+    // they can't be trusted while one is pending: the voices stay where they are.
+    // Once it's taken they follow the snapshot until the parameters have caught up.
+    if (presetManager->isPresetPending())
+        return;
+
+    if (followingPreset && presetManager->haveParametersCaughtUp(presetGeneration))
+        followingPreset = false;
+
+    // Voices normally follow the parameters, or a learned controller's value until the
+    // message thread has set the parameter to it. With morphing on they follow a blend of
+    // the A and B targets, which the preset manager has already resolved to flat
+    // arrays. Continuous parameters blend in the normalised (skewed) domain, so e.g.
+    // cutoff sweeps evenly in pitch; discrete ones (waveforms, switches, unison
+    // count) flip from A to B halfway through.
+    bool bothLoaded = false;
+    if (presetManager->copyMorphTargets(morphTargetA, morphTargetB, morphGeneration, bothLoaded))
+        morphTargetsReady = bothLoaded;
+
+    const bool morphing = morphTargetsReady && morphEnabledParam->get();
+    const float amount = morphParam->convertFrom0to1(
+        midiLearn->getControlledValue(morphParam->getParameterIndex(), morphParam->getValue()));
+    const auto& parameterList = presetManager->getParameterList();
+
+    for (size_t i = 0; i < voiceValues.size(); ++i)
+    {
+        auto* parameter = parameterList.getUnchecked(static_cast<int>(i));
+        float normalised = followingPreset ? presetValues[i]
+                                           : midiLearn->getControlledValue(static_cast<int>(i), parameter->getValue());
+
+        if (morphing)
+        {
+            if (discreteParameters[i])
+                normalised = amount < 0.5f ? morphTargetA[i] : morphTargetB[i];
+            else
+                normalised = morphTargetA[i] + amount * (morphTargetB[i] - morphTargetA[i]);
+        }
+
+        voiceValues[i] = parameter->convertFrom0to1(normalised);
+    }
+}
+
 //==============================================================================
 bool Successor37AudioProcessor::hasEditor() const
 {
@@ -258,19 +630,65 @@ juce::AudioProcessorEditor* Successor37AudioProcessor::createEditor()
 //==============================================================================
 void Successor37AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary state, read straight from the parameters (no ValueTree copy or XML).
+    // MIDI mappings, morph targets and the sequence aren't parameters, so they go in chunks.
+    std::vector<BinaryState::Chunk> chunks(3);
+    chunks[0].tag = MidiLearn::stateChunkTag;
+    midiLearn->writeState(chunks[0].data);
+    chunks[1].tag = PresetManager::morphChunkTag;
+    presetManager->writeMorphState(chunks[1].data);
+    chunks[2].tag = StepSequencer::stateChunkTag;
+    stepSequencer.writeState(chunks[2].data);
+
+    BinaryState::write(presetManager->getParameterList(), destData, chunks);
 }
 
 void Successor37AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (BinaryState::isBinaryState(data, sizeInBytes))
+    {
+        std::vector<float> values;
+        std::vector<BinaryState::Chunk> chunks;
+        if (BinaryState::read(data, sizeInBytes, presetManager->getParameterList(), values, &chunks))
+        {
+            presetManager->restoreValues(values);
+
+            // A state without mappings, morph targets or a sequence (or from before them) has none
+            bool restoredMappings = false;
+            bool restoredMorphTargets = false;
+            bool restoredSequence = false;
+            for (const auto& chunk : chunks)
+            {
+                if (chunk.tag == MidiLearn::stateChunkTag)
+                    restoredMappings = midiLearn->restoreState(chunk.data.getData(), chunk.data.getSize());
+                else if (chunk.tag == PresetManager::morphChunkTag)
+                    restoredMorphTargets = presetManager->restoreMorphState(chunk.data.getData(), chunk.data.getSize());
+                else if (chunk.tag == StepSequencer::stateChunkTag)
+                    restoredSequence = stepSequencer.restoreState(chunk.data.getData(), chunk.data.getSize());
+            }
+
+            if (!restoredMappings)
+                midiLearn->clearMappings();
+            if (!restoredMorphTargets)
+                presetManager->clearMorphTargets();
+            if (!restoredSequence)
+                stepSequencer.resetState();
+        }
+        return;
+    }
+
+    // Sessions saved before the binary format store the state as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr)
     {
+        midiLearn->clearMappings();
+        presetManager->clearMorphTargets();
+        stepSequencer.resetState();
+
+        // Applied at a block boundary, not from whichever thread the host calls us on
         if (xmlState->hasTagName(parameters.state.getType()))
         {
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+            presetManager->restoreState(juce::ValueTree::fromXml(*xmlState));
         }
     }
 }
@@ -296,6 +714,68 @@ juce::AudioProcessorValueTreeState::ParameterLayout Successor37AudioProcessor::c
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f
     ));
 
+    // Oscillator 2, Sub and Noise
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "osc2Waveform", "Oscillator 2 Waveform",
+        juce::StringArray{"Sine", "Saw", "Square", "Triangle"}, 1
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "osc2Tune", "Oscillator 2 Tune",
+        juce::NormalisableRange<float>(-24.0f, 24.0f, 1.0f), 0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "osc2Fine", "Oscillator 2 Fine",
+        juce::NormalisableRange<float>(-50.0f, 50.0f, 0.1f), 0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "osc2PWM", "Oscillator 2 Pulse Width",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "hardSync", "Hard Sync", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "osc1Level", "Oscillator 1 Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "osc2Level", "Oscillator 2 Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "subLevel", "Sub Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "noiseLevel", "Noise Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f
+    ));
+
+    // Unison Parameters
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "unisonVoices", "Unison Voices", 1, 16, 1
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "unisonDetune", "Unison Detune",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
+        10.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "unisonSpread", "Unison Spread",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f
+    ));
+
     // Filter Parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "filterCutoff", "Filter Cutoff",
@@ -378,6 +858,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout Successor37AudioProcessor::c
         0
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "lfo1Sync", "LFO 1 Tempo Sync", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "lfo1Division", "LFO 1 Division",
+        LFO::getDivisionNames(),
+        LFO::Quarter
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "lfo1KeySync", "LFO 1 Key Sync", true
+    ));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "lfo1ToFilter", "LFO 1 > Filter",
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
@@ -390,6 +884,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout Successor37AudioProcessor::c
         0.0f
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "lfo1ToPWM", "LFO 1 > PWM",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
     // LFO 2 Parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "lfo2Rate", "LFO 2 Rate",
@@ -403,6 +903,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout Successor37AudioProcessor::c
         0
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "lfo2Sync", "LFO 2 Tempo Sync", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "lfo2Division", "LFO 2 Division",
+        LFO::getDivisionNames(),
+        LFO::Quarter
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "lfo2KeySync", "LFO 2 Key Sync", true
+    ));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "lfo2ToFilter", "LFO 2 > Filter",
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
@@ -447,6 +961,132 @@ juce::AudioProcessorValueTreeState::ParameterLayout Successor37AudioProcessor::c
         0.7f
     ));
 
+    // Voice Allocation Parameters
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "notePriority", "Note Priority",
+        juce::StringArray{"Last", "First", "Highest", "Lowest"},
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "voiceStealMode", "Voice Stealing",
+        juce::StringArray{"Oldest", "Quietest", "Lowest Envelope"},
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "voiceMode", "Voice Mode",
+        juce::StringArray{"Poly", "Mono", "Legato", "Paraphonic"},
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "glideTime", "Glide Time",
+        juce::NormalisableRange<float>(0.0f, 2000.0f, 0.1f, 0.5f),
+        0.0f
+    ));
+
+    // Preset morphing between the A and B targets (see PresetManager::loadMorphTarget)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "morph", "Morph A/B",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "morphEnabled", "Morph Enabled", false
+    ));
+
+    // Arpeggiator
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "arpEnabled", "Arp Enabled", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "arpPattern", "Arp Pattern",
+        juce::StringArray{"Up", "Down", "Up/Down", "Random"},
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "arpRate", "Arp Rate",
+        juce::NormalisableRange<float>(0.1f, 50.0f, 0.01f, 0.3f),
+        2.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "arpSync", "Arp Sync", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "arpDivision", "Arp Division",
+        Arpeggiator::getDivisionNames(),
+        Arpeggiator::SIXTEENTH
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "arpSwing", "Arp Swing",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "arpGate", "Arp Gate",
+        juce::NormalisableRange<float>(0.05f, 1.0f, 0.01f),
+        0.8f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "arpOctaves", "Arp Octaves", 1, 4, 1
+    ));
+
+    // Step sequencer. Its lanes aren't parameters, they're saved in a state chunk.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "seqEnabled", "Sequencer Enabled", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "seqRecord", "Sequencer Record", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "seqDivision", "Sequencer Division",
+        Arpeggiator::getDivisionNames(),
+        Arpeggiator::SIXTEENTH
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "seqSwing", "Sequencer Swing",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    // The modulation lane's depth, through each voice's modulation matrix
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "seqToFilter", "Sequencer > Filter",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "seqToPitch", "Sequencer > Pitch",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    // Sends the arpeggiator/sequencer output to the host as well as the synth
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "midiOutput", "MIDI Output", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "multiCoreRendering", "Multi-Core Rendering", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "multiCoreThreshold", "Multi-Core Voice Threshold", 2, VoiceAllocator::maxVoices, 4
+    ));
+
     return { params.begin(), params.end() };
 }
 
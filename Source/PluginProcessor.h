@@ -4,17 +4,16 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "VoiceAllocator.h"
 #include "Arpeggiator.h"
+#include "StepSequencer.h"
+#include "Telemetry.h"
 #include "StereoDelay.h"
 #include "Chorus.h"
 #include "PresetManager.h"
-
-enum class NotePriority {
-    LastNote,
-    FirstNote,
-    HighestNote,
-    LowestNote
-};
+#include "BinaryState.h"
+#include "MidiLearn.h"
+#include "TaskScheduler.h"
 
 class Successor37AudioProcessor : public juce::AudioProcessor
 {
@@ -26,6 +25,7 @@ public:
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void setNonRealtime(bool isNonRealtime) noexcept override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
@@ -56,28 +56,68 @@ public:
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
     juce::Synthesiser& getSynth() { return synth; }
     PresetManager* getPresetManager() { return presetManager.get(); }
+    MidiLearn& getMidiLearn() { return *midiLearn; }
+    StepSequencer& getStepSequencer() { return stepSequencer; }
+    Telemetry& getTelemetry() { return telemetry; }
+    float getOutputPeak(int channel) const { return outputPeaks[static_cast<size_t>(channel & 1)].load(); } // Updated while telemetry is active
+
+    // Caps the threads used by one processor, including the audio thread (0 = all cores).
+    // Takes effect on the next prepareToPlay; batch renders use 1 per instance.
+    void setMaxThreads(int numThreads) { maxThreads = juce::jmax(0, numThreads); }
 
 private:
     //==============================================================================
+    // Worker threads shared by voice rendering and the effects graph
+    TaskScheduler scheduler;
+    TaskGraph effectsGraph;
+    int maxThreads = 0;
+
     // Audio processing components
-    juce::Synthesiser synth;
+    VoiceAllocator synth;
     std::unique_ptr<SynthSound> synthSound;
     
     // Effects
     StereoDelay delay;
     Chorus chorus;
+    std::array<std::atomic<float>, 2> outputPeaks {};
+    Telemetry telemetry;
     Arpeggiator arpeggiator;
+    StepSequencer stepSequencer;
 
-    // Preset system
-    std::unique_ptr<PresetManager> presetManager;
+    // What the synth plays this block: the input the arpeggiator didn't take, plus the
+    // notes the arpeggiator and sequencer generated. Only the generated ones go to the
+    // host, with MIDI output on. Preallocated in prepareToPlay.
+    juce::MidiBuffer processedMidi;
+    juce::MidiBuffer generatedMidi;
+
+    // Generated notes the host has had a note-on for, per channel
+    std::array<std::array<juce::uint64, 2>, 16> outputNotesOn {};
+    bool midiOutputWasEnabled = false;
 
     // Parameters
     juce::AudioProcessorValueTreeState parameters;
+
+    // Preset system, declared after parameters so its loader thread stops first
+    std::unique_ptr<PresetManager> presetManager;
+    static constexpr double presetFadeSeconds = 0.01; // Each way, for crossfading preset loads
+    juce::SmoothedValue<float> presetFadeGain { 1.0f };
+
+    // Controller mappings, indexed by the preset manager's parameter list
+    std::unique_ptr<MidiLearn> midiLearn;
     
     // Parameter pointers (for faster access)
     juce::AudioParameterChoice* oscWaveformParam;
     juce::AudioParameterFloat* oscTuneParam;
     juce::AudioParameterFloat* oscPWMParam;
+    juce::AudioParameterChoice* osc2WaveformParam;
+    juce::AudioParameterFloat* osc2TuneParam;
+    juce::AudioParameterFloat* osc2FineParam;
+    juce::AudioParameterFloat* osc2PWMParam;
+    juce::AudioParameterBool* hardSyncParam;
+    juce::AudioParameterFloat* osc1LevelParam;
+    juce::AudioParameterFloat* osc2LevelParam;
+    juce::AudioParameterFloat* subLevelParam;
+    juce::AudioParameterFloat* noiseLevelParam;
     juce::AudioParameterFloat* filterCutoffParam;
     juce::AudioParameterFloat* filterResonanceParam;
     juce::AudioParameterFloat* filterDriveParam;
@@ -91,14 +131,86 @@ private:
     juce::AudioParameterFloat* filterSustainParam;
     juce::AudioParameterFloat* filterReleaseParam;
     juce::AudioParameterFloat* masterVolumeParam;
+    juce::AudioParameterChoice* notePriorityParam;
+    juce::AudioParameterChoice* voiceStealModeParam;
+    juce::AudioParameterChoice* voiceModeParam;
+    juce::AudioParameterFloat* glideTimeParam;
+    juce::AudioParameterInt* unisonVoicesParam;
+    juce::AudioParameterFloat* unisonDetuneParam;
+    juce::AudioParameterFloat* unisonSpreadParam;
+    juce::AudioParameterFloat* lfo1RateParam;
+    juce::AudioParameterChoice* lfo1WaveformParam;
+    juce::AudioParameterBool* lfo1SyncParam;
+    juce::AudioParameterChoice* lfo1DivisionParam;
+    juce::AudioParameterBool* lfo1KeySyncParam;
+    juce::AudioParameterFloat* lfo1ToFilterParam;
+    juce::AudioParameterFloat* lfo1ToPitchParam;
+    juce::AudioParameterFloat* lfo1ToPWMParam;
+    juce::AudioParameterFloat* lfo2RateParam;
+    juce::AudioParameterChoice* lfo2WaveformParam;
+    juce::AudioParameterBool* lfo2SyncParam;
+    juce::AudioParameterChoice* lfo2DivisionParam;
+    juce::AudioParameterBool* lfo2KeySyncParam;
+    juce::AudioParameterFloat* lfo2ToFilterParam;
+    juce::AudioParameterFloat* lfo2ToPitchParam;
+    juce::AudioParameterFloat* modWheelToFilterParam;
+    juce::AudioParameterFloat* velocityToFilterParam;
+    juce::AudioParameterFloat* velocityToAmpParam;
+    juce::AudioParameterFloat* morphParam;
+    juce::AudioParameterBool* morphEnabledParam;
+    juce::AudioParameterBool* arpEnabledParam;
+    juce::AudioParameterChoice* arpPatternParam;
+    juce::AudioParameterFloat* arpRateParam;
+    juce::AudioParameterBool* arpSyncParam;
+    juce::AudioParameterChoice* arpDivisionParam;
+    juce::AudioParameterFloat* arpSwingParam;
+    juce::AudioParameterFloat* arpGateParam;
+    juce::AudioParameterInt* arpOctavesParam;
+    juce::AudioParameterBool* seqEnabledParam;
+    juce::AudioParameterBool* seqRecordParam;
+    juce::AudioParameterChoice* seqDivisionParam;
+    juce::AudioParameterFloat* seqSwingParam;
+    juce::AudioParameterFloat* seqToFilterParam;
+    juce::AudioParameterFloat* seqToPitchParam;
+    juce::AudioParameterBool* midiOutputParam;
+    juce::AudioParameterBool* multiCoreRenderingParam;
+    juce::AudioParameterInt* multiCoreThresholdParam;
+
+    // Plain values the voices get this block, indexed like getParameters(): the
+    // parameters themselves, a preset snapshot the parameters haven't caught up with
+    // yet, or the A/B morph when it's enabled
+    std::vector<float> voiceValues;
+    std::vector<float> presetValues; // Normalised
+    juce::uint32 presetGeneration = 0;
+    bool followingPreset = false;
+    std::vector<float> morphTargetA, morphTargetB; // Normalised
+    std::vector<bool> discreteParameters;
+    juce::uint32 morphGeneration = 0;
+    bool morphTargetsReady = false;
+
+    // Offline bounce mode (isNonRealtime): every core is used for voices and effects,
+    // and parameters are pushed to the voices every offlineControlInterval samples
+    // rather than every block. With static parameters the result matches a realtime
+    // render to float rounding (the parallel voice sum, around 1e-6); automation
+    // lands up to offlineControlInterval samples (~5ms at 48kHz) later.
+    static constexpr int offlineControlInterval = 256;
+    int samplesUntilParameterUpdate = 0;
 
     // Host info
     double currentBPM = 120.0;
+    double currentPPQ = 0.0;
     bool isPlaying = false;
 
     // Helper methods
     void updateHostInfo();
     void updateParameters();
+    void updateVoiceValues();
+    float getVoiceValue(const juce::RangedAudioParameter* parameter) const { return voiceValues[static_cast<size_t>(parameter->getParameterIndex())]; }
+    void updateVoiceTransport();
+    void sendMidiOutput(juce::MidiBuffer& midiMessages, int numSamples);
+    void processEffects(juce::AudioBuffer<float>& buffer);
+    void updateOutputPeaks(const juce::AudioBuffer<float>& buffer);
+    void pushTelemetry(const juce::AudioBuffer<float>& buffer, juce::int64 blockStartTicks);
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Successor37AudioProcessor)
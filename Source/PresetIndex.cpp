@@ -0,0 +1,295 @@
+#include "PresetIndex.h"
+
+PresetIndex::PresetIndex(const juce::File& directory, const juce::File& file)
+    : presetDirectory(directory), indexFile(file)
+{
+}
+
+int PresetIndex::refresh()
+{
+    ensureLoaded();
+    
+    auto files = presetDirectory.findChildFiles(juce::File::findFiles, false, "*.xml");
+    
+    std::unordered_map<juce::String, size_t> existing;
+    existing.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        existing.emplace(entries[i].fileName, i);
+    }
+    
+    std::vector<Entry> refreshed;
+    refreshed.reserve(static_cast<size_t>(files.size()));
+    std::unordered_map<juce::String, FileStamp> stillFailing;
+    int numParsed = 0;
+    bool changed = false;
+    
+    for (const auto& file : files) {
+        const auto modificationTime = file.getLastModificationTime().toMilliseconds();
+        const auto fileSize = file.getSize();
+        
+        // Unchanged files keep their cached entry, only new or edited ones are parsed
+        auto found = existing.find(file.getFileName());
+        if (found != existing.end()) {
+            auto& cached = entries[found->second];
+            if (cached.modificationTime == modificationTime && cached.fileSize == fileSize) {
+                refreshed.push_back(std::move(cached));
+                continue;
+            }
+        }
+        
+        // Likewise a file that failed to parse isn't tried again until it changes
+        auto failed = failedFiles.find(file.getFileName());
+        if (failed != failedFiles.end()
+            && failed->second.modificationTime == modificationTime && failed->second.fileSize == fileSize) {
+            stillFailing.emplace(failed->first, failed->second);
+            continue;
+        }
+        
+        Entry entry;
+        if (parseEntry(file, entry)) {
+            refreshed.push_back(std::move(entry));
+        } else {
+            stillFailing.emplace(file.getFileName(), FileStamp { modificationTime, fileSize });
+        }
+        changed = true;
+        ++numParsed;
+    }
+    
+    // Anything not seen again was deleted
+    changed = changed || refreshed.size() != entries.size() || stillFailing.size() != failedFiles.size();
+    entries = std::move(refreshed);
+    failedFiles = std::move(stillFailing);
+    sortEntries();
+    
+    if (changed) {
+        save();
+    }
+    return numParsed;
+}
+
+void PresetIndex::update(const juce::File& presetFile)
+{
+    // Otherwise saving a preset first would replace the saved index with this one entry
+    ensureLoaded();
+    
+    const auto fileName = presetFile.getFileName();
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&fileName](const Entry& e) { return e.fileName == fileName; }),
+                  entries.end());
+    
+    Entry entry;
+    if (parseEntry(presetFile, entry)) {
+        entries.push_back(std::move(entry));
+        sortEntries();
+        failedFiles.erase(fileName);
+    } else {
+        failedFiles[fileName] = { presetFile.getLastModificationTime().toMilliseconds(), presetFile.getSize() };
+    }
+    save();
+}
+
+std::vector<const PresetIndex::Entry*> PresetIndex::search(const juce::String& text, const juce::StringArray& requiredTags) const
+{
+    const auto needle = text.trim().toLowerCase();
+    std::vector<const Entry*> results;
+    
+    for (const auto& entry : entries) {
+        if (needle.isNotEmpty() && !entry.searchText.contains(needle)) {
+            continue;
+        }
+        
+        bool hasAllTags = true;
+        for (const auto& tag : requiredTags) {
+            if (!entry.metadata.tags.contains(tag, true)) {
+                hasAllTags = false;
+                break;
+            }
+        }
+        
+        if (hasAllTags) {
+            results.push_back(&entry);
+        }
+    }
+    return results;
+}
+
+juce::StringArray PresetIndex::getAllTags() const
+{
+    juce::StringArray tags;
+    for (const auto& entry : entries) {
+        tags.addArray(entry.metadata.tags);
+    }
+    tags.removeDuplicates(true);
+    tags.sortNatural();
+    return tags;
+}
+
+void PresetIndex::writeMetadata(juce::XmlElement& preset, const Metadata& metadata)
+{
+    preset.setAttribute("category", metadata.category);
+    preset.setAttribute("author", metadata.author);
+    preset.setAttribute("tags", metadata.tags.joinIntoString(","));
+}
+
+PresetIndex::Metadata PresetIndex::readMetadata(const juce::XmlElement& preset)
+{
+    Metadata metadata;
+    metadata.category = preset.getStringAttribute("category");
+    metadata.author = preset.getStringAttribute("author");
+    metadata.tags.addTokens(preset.getStringAttribute("tags"), ",", "");
+    metadata.tags.trim();
+    metadata.tags.removeEmptyStrings();
+    return metadata;
+}
+
+bool PresetIndex::parseEntry(const juce::File& presetFile, Entry& entry) const
+{
+    std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(presetFile));
+    if (xml == nullptr) {
+        return false;
+    }
+    
+    entry.fileName = presetFile.getFileName();
+    entry.modificationTime = presetFile.getLastModificationTime().toMilliseconds();
+    entry.fileSize = presetFile.getSize();
+    entry.name = presetFile.getFileNameWithoutExtension();
+    entry.metadata = readMetadata(*xml);
+    entry.fingerprint = computeFingerprint(*xml);
+    updateSearchText(entry);
+    return true;
+}
+
+juce::uint64 PresetIndex::computeFingerprint(const juce::XmlElement& preset)
+{
+    // FNV-1a over the parameters sorted by ID, values rounded so that re-saving a
+    // preset doesn't change its fingerprint through float formatting
+    std::vector<std::pair<juce::String, juce::int64>> values;
+    for (auto* param : preset.getChildWithTagNameIterator("PARAM")) {
+        const auto rounded = static_cast<juce::int64>(std::llround(param->getDoubleAttribute("value") * 10000.0));
+        values.emplace_back(param->getStringAttribute("id"), rounded);
+    }
+    std::sort(values.begin(), values.end());
+    
+    juce::uint64 hash = 14695981039346656037ull;
+    auto addBytes = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    
+    for (const auto& [id, value] : values) {
+        addBytes(id.toRawUTF8(), id.getNumBytesAsUTF8());
+        addBytes(&value, sizeof(value));
+    }
+    return hash;
+}
+
+void PresetIndex::updateSearchText(Entry& entry)
+{
+    entry.searchText = (entry.name + "\n" + entry.metadata.category + "\n" + entry.metadata.author + "\n"
+                        + entry.metadata.tags.joinIntoString("\n")).toLowerCase();
+}
+
+void PresetIndex::sortEntries()
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.fileName.compareNatural(b.fileName) < 0;
+    });
+}
+
+void PresetIndex::ensureLoaded()
+{
+    if (!loaded) {
+        load();
+        loaded = true;
+    }
+}
+
+bool PresetIndex::load()
+{
+    juce::MemoryBlock data;
+    if (!indexFile.loadFileAsData(data)) {
+        return false;
+    }
+    
+    juce::MemoryInputStream in(data, false);
+    if (static_cast<juce::uint32>(in.readInt()) != fileMagic || in.readInt() != fileVersion) {
+        return false; // Unknown format: refresh() rebuilds it
+    }
+    
+    const int numEntries = in.readInt();
+    std::vector<Entry> loadedEntries;
+    loadedEntries.reserve(static_cast<size_t>(juce::jmax(0, numEntries)));
+    
+    for (int i = 0; i < numEntries && !in.isExhausted(); ++i) {
+        Entry entry;
+        entry.fileName = in.readString();
+        entry.modificationTime = in.readInt64();
+        entry.fileSize = in.readInt64();
+        entry.name = in.readString();
+        entry.metadata.category = in.readString();
+        entry.metadata.author = in.readString();
+        
+        const int numTags = in.readInt();
+        for (int t = 0; t < numTags && !in.isExhausted(); ++t) {
+            entry.metadata.tags.add(in.readString());
+        }
+        
+        entry.fingerprint = static_cast<juce::uint64>(in.readInt64());
+        updateSearchText(entry);
+        loadedEntries.push_back(std::move(entry));
+    }
+    
+    const int numFailed = in.readInt();
+    std::unordered_map<juce::String, FileStamp> loadedFailures;
+    for (int i = 0; i < numFailed && !in.isExhausted(); ++i) {
+        auto fileName = in.readString();
+        FileStamp stamp;
+        stamp.modificationTime = in.readInt64();
+        stamp.fileSize = in.readInt64();
+        loadedFailures.emplace(std::move(fileName), stamp);
+    }
+    
+    if (static_cast<int>(loadedEntries.size()) != numEntries || static_cast<int>(loadedFailures.size()) != numFailed) {
+        return false; // Truncated
+    }
+    
+    entries = std::move(loadedEntries);
+    failedFiles = std::move(loadedFailures);
+    sortEntries();
+    return true;
+}
+
+bool PresetIndex::save() const
+{
+    juce::MemoryOutputStream out;
+    out.writeInt(static_cast<int>(fileMagic));
+    out.writeInt(fileVersion);
+    out.writeInt(static_cast<int>(entries.size()));
+    
+    for (const auto& entry : entries) {
+        out.writeString(entry.fileName);
+        out.writeInt64(entry.modificationTime);
+        out.writeInt64(entry.fileSize);
+        out.writeString(entry.name);
+        out.writeString(entry.metadata.category);
+        out.writeString(entry.metadata.author);
+        out.writeInt(entry.metadata.tags.size());
+        for (const auto& tag : entry.metadata.tags) {
+            out.writeString(tag);
+        }
+        out.writeInt64(static_cast<juce::int64>(entry.fingerprint));
+    }
+    
+    out.writeInt(static_cast<int>(failedFiles.size()));
+    for (const auto& [fileName, stamp] : failedFiles) {
+        out.writeString(fileName);
+        out.writeInt64(stamp.modificationTime);
+        out.writeInt64(stamp.fileSize);
+    }
+    
+    // Write to a temporary file and swap it in, so a crash never leaves half an index
+    juce::TemporaryFile temp(indexFile);
+    return temp.getFile().replaceWithData(out.getData(), out.getDataSize()) && temp.overwriteTargetFileWithTemporary();
+}
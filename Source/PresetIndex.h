@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Cached metadata for every preset in a folder, kept in a small binary file next to
+// it so a browser never has to parse thousands of XML files. refresh() only re-reads
+// presets whose modification time or size changed; files that don't parse are
+// remembered the same way, so a broken preset is tried once per edit, not per
+// refresh. Message thread only.
+class PresetIndex
+{
+public:
+    struct Metadata
+    {
+        juce::String category;
+        juce::String author;
+        juce::StringArray tags;
+    };
+
+    struct Entry
+    {
+        juce::String fileName; // Relative to the preset folder
+        juce::int64 modificationTime = 0;
+        juce::int64 fileSize = 0;
+        juce::String name;
+        Metadata metadata;
+        juce::uint64 fingerprint = 0; // Hash of the parameter values, equal for identical sounds
+
+        juce::String searchText; // Lower-case name, category, author and tags, not stored
+    };
+
+    PresetIndex(const juce::File& presetDirectory, const juce::File& indexFile);
+
+    // Brings the index up to date with the folder and saves it if anything changed.
+    // Returns the number of presets that had to be parsed.
+    int refresh();
+
+    // Re-reads one preset straight away, e.g. after saving it
+    void update(const juce::File& presetFile);
+
+    // Case-insensitive substring match on name, category, author and tags; an entry
+    // must also carry every tag in requiredTags. Results are in file name order and
+    // stay valid until the next refresh() or update().
+    std::vector<const Entry*> search(const juce::String& text, const juce::StringArray& requiredTags = {}) const;
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+    juce::StringArray getAllTags() const;
+
+    // Preset files carry their metadata as attributes on the root element
+    static void writeMetadata(juce::XmlElement& preset, const Metadata& metadata);
+    static Metadata readMetadata(const juce::XmlElement& preset);
+
+private:
+    static constexpr juce::uint32 fileMagic = 0x49373353; // "S37I"
+    static constexpr int fileVersion = 2;
+
+    struct FileStamp
+    {
+        juce::int64 modificationTime = 0;
+        juce::int64 fileSize = 0;
+    };
+
+    juce::File presetDirectory;
+    juce::File indexFile;
+    std::vector<Entry> entries; // Sorted by fileName
+    std::unordered_map<juce::String, FileStamp> failedFiles; // Presets that didn't parse
+    bool loaded = false;
+
+    void ensureLoaded(); // Reads the saved index once, before the first change
+    bool load();
+    bool save() const;
+    bool parseEntry(const juce::File& presetFile, Entry& entry) const;
+    static juce::uint64 computeFingerprint(const juce::XmlElement& preset);
+    static void updateSearchText(Entry& entry);
+    void sortEntries();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIndex)
+};
@@ -1,8 +1,32 @@
 #include "PresetManager.h"
+#include "BinaryState.h"
 
-PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts) : valueTreeState(apvts) {}
+PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts)
+    : valueTreeState(apvts),
+      index(getPresetDirectory(), getPresetDirectory().getSiblingFile("PresetIndex.bin")),
+      loader(*this)
+{
+    for (auto* parameter : valueTreeState.processor.getParameters()) {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter)) {
+            parameterList.add(ranged);
+        }
+    }
+    
+    pendingValues.resize(static_cast<size_t>(parameterList.size()));
+    parameterValues.resize(pendingValues.size());
+    for (auto& target : morphTargets) {
+        target.resize(pendingValues.size());
+    }
+    loader.startThread();
+}
+
+PresetManager::~PresetManager()
+{
+    loader.stopThread(2000);
+    cancelPendingUpdate();
+}
 
-void PresetManager::savePreset(const juce::String& presetName)
+void PresetManager::savePreset(const juce::String& presetName, const PresetIndex::Metadata& metadata)
 {
     auto presetDirectory = getPresetDirectory();
     if (!presetDirectory.exists()) {
@@ -12,36 +36,347 @@ void PresetManager::savePreset(const juce::String& presetName)
     auto presetFile = presetDirectory.getChildFile(presetName + ".xml");
     auto state = valueTreeState.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    PresetIndex::writeMetadata(*xml, metadata);
     xml->writeTo(presetFile);
+    index.update(presetFile);
     
+    const juce::ScopedLock sl(nameLock);
     currentPresetName = presetName;
 }
 
-void PresetManager::loadPreset(const juce::String& presetName)
+void PresetManager::loadPreset(const juce::String& presetName, bool crossfade)
+{
+    loadPresetFileAsync(getPresetDirectory().getChildFile(presetName + ".xml"), crossfade);
+}
+
+void PresetManager::loadPresetFileAsync(const juce::File& presetFile, bool crossfade)
+{
+    loader.load(presetFile, crossfade);
+}
+
+bool PresetManager::loadPresetFile(const juce::File& presetFile)
+{
+    std::vector<float> values;
+    if (!buildSnapshot(presetFile, values)) {
+        return false;
+    }
+    
+    // Straight to the parameters; the voices follow at the next block
+    setParameters(values, storeParameterValues(values));
+    
+    const juce::ScopedLock sl(nameLock);
+    currentPresetName = presetFile.getFileNameWithoutExtension();
+    return true;
+}
+
+bool PresetManager::restoreState(const juce::ValueTree& state)
+{
+    std::vector<float> values;
+    if (!buildSnapshot(state, values)) {
+        return false;
+    }
+    
+    restoreValues(values);
+    return true;
+}
+
+void PresetManager::restoreValues(const std::vector<float>& normalisedValues)
+{
+    jassert(normalisedValues.size() == pendingValues.size());
+    
+    publishSnapshot(normalisedValues, false);
+}
+
+bool PresetManager::loadMorphTarget(MorphSlot slot, const juce::File& presetFile)
+{
+    std::vector<float> values;
+    if (!buildSnapshot(presetFile, values)) {
+        return false;
+    }
+    
+    setMorphTarget(slot, values);
+    return true;
+}
+
+void PresetManager::setMorphTargetFromCurrent(MorphSlot slot)
+{
+    std::vector<float> values;
+    for (auto* parameter : parameterList) {
+        values.push_back(parameter->getValue());
+    }
+    setMorphTarget(slot, values);
+}
+
+void PresetManager::setMorphTarget(MorphSlot slot, const std::vector<float>& values)
+{
+    const juce::SpinLock::ScopedLockType sl(morphLock);
+    std::copy(values.begin(), values.end(), morphTargets[static_cast<size_t>(slot)].begin());
+    morphTargetLoaded[static_cast<size_t>(slot)] = true;
+    ++morphGeneration;
+}
+
+bool PresetManager::copyMorphTargets(std::vector<float>& a, std::vector<float>& b,
+                                     juce::uint32& generation, bool& bothLoaded) noexcept
+{
+    if (morphGeneration.load() == generation) {
+        return false;
+    }
+    
+    const juce::SpinLock::ScopedTryLockType tl(morphLock);
+    if (!tl.isLocked()) {
+        return false; // A target is being written, pick it up next block
+    }
+    
+    std::copy(morphTargets[0].begin(), morphTargets[0].end(), a.begin());
+    std::copy(morphTargets[1].begin(), morphTargets[1].end(), b.begin());
+    bothLoaded = morphTargetLoaded[0] && morphTargetLoaded[1];
+    generation = morphGeneration.load();
+    return true;
+}
+
+void PresetManager::writeMorphState(juce::MemoryBlock& destData) const
 {
-    auto presetFile = getPresetDirectory().getChildFile(presetName + ".xml");
-    if (presetFile.existsAsFile()) {
-        std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(presetFile));
-        if (xml != nullptr) {
-            valueTreeState.replaceState(juce::ValueTree::fromXml(*xml));
-            currentPresetName = presetName;
+    const juce::SpinLock::ScopedLockType sl(morphLock);
+    
+    juce::MemoryOutputStream out(destData, false);
+    out.writeInt(1); // Version
+    for (size_t slot = 0; slot < morphTargets.size(); ++slot) {
+        out.writeBool(morphTargetLoaded[slot]);
+        out.writeInt(morphTargetLoaded[slot] ? parameterList.size() : 0);
+        if (!morphTargetLoaded[slot]) {
+            continue;
+        }
+        
+        for (int i = 0; i < parameterList.size(); ++i) {
+            auto* parameter = parameterList.getUnchecked(i);
+            out.writeInt(static_cast<int>(BinaryState::hashParameterID(parameter->getParameterID())));
+            out.writeFloat(parameter->convertFrom0to1(morphTargets[slot][static_cast<size_t>(i)]));
         }
     }
+    
+    out.flush();
+    destData.setSize(out.getDataSize());
 }
 
-juce::StringArray PresetManager::getAllPresets() const
+bool PresetManager::restoreMorphState(const void* data, size_t sizeInBytes)
 {
-    juce::StringArray presets;
-    auto presetDirectory = getPresetDirectory();
+    juce::MemoryInputStream in(data, sizeInBytes, false);
+    if (in.readInt() < 1) {
+        return false;
+    }
+    
+    std::unordered_map<juce::uint32, int> indexByHash;
+    for (int i = 0; i < parameterList.size(); ++i) {
+        indexByHash.emplace(BinaryState::hashParameterID(parameterList.getUnchecked(i)->getParameterID()), i);
+    }
     
-    if (presetDirectory.exists()) {
-        auto files = presetDirectory.findChildFiles(juce::File::findFiles, false, "*.xml");
-        for (const auto& file : files) {
-            presets.add(file.getFileNameWithoutExtension());
+    std::array<std::vector<float>, 2> restored;
+    std::array<bool, 2> loaded { false, false };
+    for (size_t slot = 0; slot < restored.size(); ++slot) {
+        loaded[slot] = in.readBool();
+        const int numStored = in.readInt();
+        if (numStored < 0 || in.getNumBytesRemaining() < static_cast<juce::int64>(numStored) * 8) {
+            return false; // Truncated
+        }
+        
+        for (auto* parameter : parameterList) {
+            restored[slot].push_back(parameter->getDefaultValue());
         }
+        
+        for (int i = 0; i < numStored; ++i) {
+            const auto hash = static_cast<juce::uint32>(in.readInt());
+            const float value = in.readFloat();
+            auto found = indexByHash.find(hash);
+            if (found != indexByHash.end()) {
+                auto* parameter = parameterList.getUnchecked(found->second);
+                restored[slot][static_cast<size_t>(found->second)] = parameter->convertTo0to1(value);
+            }
+        }
+    }
+    
+    const juce::SpinLock::ScopedLockType sl(morphLock);
+    morphTargets = std::move(restored);
+    morphTargetLoaded = loaded;
+    ++morphGeneration;
+    return true;
+}
+
+void PresetManager::clearMorphTargets()
+{
+    const juce::SpinLock::ScopedLockType sl(morphLock);
+    morphTargetLoaded = { false, false };
+    ++morphGeneration;
+}
+
+juce::String PresetManager::getCurrentPreset() const
+{
+    const juce::ScopedLock sl(nameLock);
+    return currentPresetName;
+}
+
+bool PresetManager::buildSnapshot(const juce::ValueTree& state, std::vector<float>& values) const
+{
+    if (!state.hasType(valueTreeState.state.getType())) {
+        return false;
+    }
+    
+    values.resize(static_cast<size_t>(parameterList.size()));
+    for (int i = 0; i < parameterList.size(); ++i) {
+        auto* parameter = parameterList.getUnchecked(i);
+        auto child = state.getChildWithProperty("id", parameter->getParameterID());
+        
+        values[static_cast<size_t>(i)] = child.isValid() && child.hasProperty("value")
+            ? parameter->convertTo0to1(static_cast<float>(child["value"]))
+            : parameter->getDefaultValue();
+    }
+    return true;
+}
+
+bool PresetManager::buildSnapshot(const juce::File& presetFile, std::vector<float>& values) const
+{
+    if (!presetFile.existsAsFile()) {
+        return false;
+    }
+    
+    std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(presetFile));
+    return xml != nullptr && buildSnapshot(juce::ValueTree::fromXml(*xml), values);
+}
+
+void PresetManager::publishSnapshot(const std::vector<float>& values, bool crossfade)
+{
+    {
+        // Held until the slot is filled, so the message thread never sets parameters
+        // from a snapshot the audio thread can't see is pending
+        const juce::ScopedLock sl(parameterValuesLock);
+        const auto generation = storeParameterValues(values);
+        
+        if (audioRunning.load()) {
+            // Overwrites a preset the audio thread hasn't picked up yet
+            presetSlot.publish([&] {
+                std::copy(values.begin(), values.end(), pendingValues.begin());
+                pendingGeneration = generation;
+                pendingCrossfade.store(crossfade);
+            });
+        }
+    }
+    
+    // A host restoring state on the message thread expects the parameters to hold it
+    // by the time setStateInformation returns
+    triggerAsyncUpdate();
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        handleUpdateNowIfNeeded();
+    }
+}
+
+bool PresetManager::takePendingPreset(std::vector<float>& normalisedValues, juce::uint32& generation) noexcept
+{
+    return presetSlot.take([&] {
+        std::copy(pendingValues.begin(), pendingValues.end(), normalisedValues.begin());
+        generation = pendingGeneration;
+    });
+}
+
+juce::uint32 PresetManager::storeParameterValues(const std::vector<float>& values)
+{
+    const juce::ScopedLock sl(parameterValuesLock);
+    std::copy(values.begin(), values.end(), parameterValues.begin());
+    return ++latestGeneration;
+}
+
+void PresetManager::setParameters(const std::vector<float>& values, juce::uint32 generation)
+{
+    for (int i = 0; i < parameterList.size(); ++i) {
+        auto* parameter = parameterList.getUnchecked(i);
+        const float value = values[static_cast<size_t>(i)];
+        if (parameter->getValue() != value) {
+            parameter->setValueNotifyingHost(value);
+        }
+    }
+    
+    // Snapshots can be set out of order (a synchronous load racing the async update),
+    // so only ever move forward
+    auto previous = parametersGeneration.load();
+    while (previous < generation && !parametersGeneration.compare_exchange_weak(previous, generation)) {
+    }
+}
+
+void PresetManager::handleAsyncUpdate()
+{
+    std::vector<float> values;
+    juce::uint32 generation;
+    {
+        const juce::ScopedLock sl(parameterValuesLock);
+        values = parameterValues;
+        generation = latestGeneration;
+    }
+    
+    setParameters(values, generation);
+}
+
+//==============================================================================
+PresetManager::Loader::Loader(PresetManager& ownerToUse)
+    : juce::Thread("Preset loader"), owner(ownerToUse)
+{
+}
+
+PresetManager::Loader::~Loader()
+{
+    stopThread(2000);
+}
+
+void PresetManager::Loader::load(const juce::File& presetFile, bool crossfade)
+{
+    {
+        const juce::ScopedLock sl(requestLock);
+        requestedFile = presetFile;
+        requestedCrossfade = crossfade;
+        hasRequest = true;
+    }
+    notify();
+}
+
+void PresetManager::Loader::run()
+{
+    std::vector<float> values;
+    
+    while (!threadShouldExit()) {
+        juce::File presetFile;
+        bool crossfade = true;
+        bool gotRequest = false;
+        {
+            const juce::ScopedLock sl(requestLock);
+            presetFile = requestedFile;
+            crossfade = requestedCrossfade;
+            gotRequest = std::exchange(hasRequest, false);
+        }
+        
+        if (!gotRequest) {
+            wait(-1);
+            continue;
+        }
+        
+        if (!owner.buildSnapshot(presetFile, values)) {
+            continue;
+        }
+        
+        owner.publishSnapshot(values, crossfade);
+        {
+            const juce::ScopedLock sl(owner.nameLock);
+            owner.currentPresetName = presetFile.getFileNameWithoutExtension();
+        }
+    }
+}
+
+juce::StringArray PresetManager::getAllPresets()
+{
+    index.refresh();
+    
+    juce::StringArray presets;
+    for (const auto& entry : index.getEntries()) {
+        presets.add(entry.name);
     }
     
-    presets.sort();
+    presets.sort(true);
     return presets;
 }
 
@@ -1,24 +1,144 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PresetIndex.h"
+#include "HandOverSlot.h"
 
-class PresetManager
+// Presets are parsed and validated on a background thread into a snapshot of
+// normalised parameter values, which goes two ways. The audio thread takes it at the
+// start of a block (see takePendingPreset) and swaps it into the values its voices
+// use, so every sound parameter changes in the same block. The parameters themselves,
+// and so the host, are updated from the message thread. Nothing on the audio thread
+// touches XML or ValueTrees or notifies the host.
+class PresetManager : private juce::AsyncUpdater
 {
 public:
     PresetManager(juce::AudioProcessorValueTreeState& apvts);
+    ~PresetManager() override;
     
-    void savePreset(const juce::String& presetName);
-    void loadPreset(const juce::String& presetName);
+    void savePreset(const juce::String& presetName, const PresetIndex::Metadata& metadata = {});
     void deletePreset(const juce::String& presetName);
     
-    juce::StringArray getAllPresets() const;
-    juce::String getCurrentPreset() const { return currentPresetName; }
+    // Asynchronous: returns straight away, the preset lands at the next block boundary.
+    // With crossfade the output dips for a few milliseconds around the switch.
+    void loadPreset(const juce::String& presetName, bool crossfade = true);
+    void loadPresetFileAsync(const juce::File& presetFile, bool crossfade = true);
+    
+    // Synchronous: sets the parameters on the calling thread, for offline renders where
+    // that thread also runs processBlock. Returns false if the file isn't a valid preset.
+    bool loadPresetFile(const juce::File& presetFile);
+    
+    // Host state restore: validated on the calling thread. On the message thread the
+    // parameters are set before this returns; the voices switch at the next block
+    // boundary. Returns false if invalid.
+    bool restoreState(const juce::ValueTree& state);
+    void restoreValues(const std::vector<float>& normalisedValues); // In getParameterList() order
+    
+    const juce::Array<juce::RangedAudioParameter*>& getParameterList() const { return parameterList; }
+    
+    // From prepareToPlay and releaseResources. While audio isn't running nothing
+    // takes snapshots, so presets only go to the parameters.
+    void setAudioRunning(bool isRunning) noexcept { audioRunning.store(isRunning); }
+    
+    // Audio thread, once per block before parameters are read. takePendingPreset
+    // copies the snapshot (sized like the parameter list) and its generation. The
+    // parameters may get its values before or after that: the caller keeps its voices
+    // where they are while one is pending, then on the snapshot until
+    // haveParametersCaughtUp(generation).
+    bool isPresetPending() const noexcept { return presetSlot.isPending(); }
+    bool pendingPresetWantsCrossfade() const noexcept { return pendingCrossfade.load(); }
+    bool takePendingPreset(std::vector<float>& normalisedValues, juce::uint32& generation) noexcept;
+    bool haveParametersCaughtUp(juce::uint32 generation) const noexcept { return parametersGeneration.load() >= generation; }
+    
+    // A/B morph targets, resolved to normalised values in getParameterList() order so
+    // the processor can blend them every block without any lookups. Message thread.
+    enum MorphSlot { morphSlotA, morphSlotB };
+    bool loadMorphTarget(MorphSlot slot, const juce::File& presetFile);
+    void setMorphTargetFromCurrent(MorphSlot slot);
+    
+    // Audio thread: copies the targets into the caller's arrays (sized like the
+    // parameter list) if they changed since generation. Never blocks; returns false
+    // if nothing was copied, in which case the caller keeps its previous copy.
+    bool copyMorphTargets(std::vector<float>& a, std::vector<float>& b,
+                          juce::uint32& generation, bool& bothLoaded) noexcept;
+    
+    // The targets aren't parameters, so they're saved as a BinaryState chunk. Values
+    // are stored plain by parameter ID hash, like the parameters themselves; ones for
+    // unknown parameters are dropped and missing ones get their defaults.
+    static constexpr juce::uint32 morphChunkTag = 0x4850524d; // "MRPH"
+    void writeMorphState(juce::MemoryBlock& destData) const;
+    bool restoreMorphState(const void* data, size_t sizeInBytes);
+    void clearMorphTargets();
+    
+    // Names come from the preset index, which is brought up to date first
+    juce::StringArray getAllPresets();
+    juce::String getCurrentPreset() const;
+    
+    // Metadata and search for preset browsers. Call refresh() before searching when
+    // the folder may have changed.
+    PresetIndex& getIndex() { return index; }
     
     static const juce::File getPresetDirectory();
     
 private:
     juce::AudioProcessorValueTreeState& valueTreeState;
+    juce::Array<juce::RangedAudioParameter*> parameterList;
+    
+    PresetIndex index;
+    
+    juce::CriticalSection nameLock;
     juce::String currentPresetName;
     
+    // Between the loader/message threads and the audio thread
+    HandOverSlot presetSlot;
+    std::vector<float> pendingValues; // Normalised, in parameterList order
+    juce::uint32 pendingGeneration = 0;
+    std::atomic<bool> pendingCrossfade { false };
+    std::atomic<bool> audioRunning { false };
+    
+    // The latest snapshot, for the message thread to set the parameters from.
+    // Generations count snapshots, so the audio thread can tell when the parameters
+    // hold the one it took.
+    juce::CriticalSection parameterValuesLock;
+    std::vector<float> parameterValues;
+    juce::uint32 latestGeneration = 0;
+    std::atomic<juce::uint32> parametersGeneration { 0 };
+    
+    // Parses a preset or saved state into normalised values, missing parameters get
+    // their defaults
+    bool buildSnapshot(const juce::ValueTree& state, std::vector<float>& values) const;
+    bool buildSnapshot(const juce::File& presetFile, std::vector<float>& values) const;
+    void publishSnapshot(const std::vector<float>& values, bool crossfade);
+    juce::uint32 storeParameterValues(const std::vector<float>& values); // Returns its generation
+    void setParameters(const std::vector<float>& values, juce::uint32 generation);
+    void handleAsyncUpdate() override;
+    
+    class Loader : public juce::Thread
+    {
+    public:
+        explicit Loader(PresetManager& owner);
+        ~Loader() override;
+        
+        void load(const juce::File& presetFile, bool crossfade);
+        void run() override;
+        
+    private:
+        PresetManager& owner;
+        juce::CriticalSection requestLock;
+        juce::File requestedFile;
+        bool requestedCrossfade = true;
+        bool hasRequest = false;
+        
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Loader)
+    };
+    
+    std::array<std::vector<float>, 2> morphTargets;
+    std::array<bool, 2> morphTargetLoaded { false, false };
+    std::atomic<juce::uint32> morphGeneration { 0 };
+    mutable juce::SpinLock morphLock;
+    void setMorphTarget(MorphSlot slot, const std::vector<float>& values);
+    
+    Loader loader;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetManager)
-};
\ No newline at end of file
+};
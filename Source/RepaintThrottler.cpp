@@ -0,0 +1,81 @@
+// RepaintThrottler.cpp
+#include "RepaintThrottler.h"
+
+RepaintThrottler::RepaintThrottler(int maxUpdatesPerSecond)
+{
+    startTimerHz(juce::jlimit(1, 120, maxUpdatesPerSecond));
+}
+
+RepaintThrottler::~RepaintThrottler()
+{
+    stopTimer();
+}
+
+void RepaintThrottler::addClient(Client* client)
+{
+    clients.push_back(client);
+}
+
+void RepaintThrottler::removeClient(Client* client)
+{
+    clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
+
+void RepaintThrottler::updateNow()
+{
+    for (auto* client : clients)
+        client->throttledUpdate();
+}
+
+//==============================================================================
+ThrottledSliderAttachment::ThrottledSliderAttachment(juce::RangedAudioParameter& p, juce::Slider& s, RepaintThrottler& t)
+    : parameter(p), slider(s), throttler(t)
+{
+    // Same mapping as SliderAttachment: the slider works in plain values on the
+    // parameter's own (possibly skewed) range, and shows the parameter's text
+    auto range = parameter.getNormalisableRange();
+    juce::NormalisableRange<double> sliderRange(
+        range.start, range.end,
+        [range](double, double, double normalised) { return static_cast<double>(range.convertFrom0to1(static_cast<float>(normalised))); },
+        [range](double, double, double value) { return static_cast<double>(range.convertTo0to1(static_cast<float>(value))); },
+        [range](double, double, double value) { return static_cast<double>(range.snapToLegalValue(static_cast<float>(value))); });
+    sliderRange.interval = range.interval;
+    sliderRange.skew = range.skew;
+    sliderRange.symmetricSkew = range.symmetricSkew;
+    slider.setNormalisableRange(sliderRange);
+
+    slider.valueFromTextFunction = [this](const juce::String& text) { return static_cast<double>(parameter.convertFrom0to1(parameter.getValueForText(text))); };
+    slider.textFromValueFunction = [this](double value) { return parameter.getText(parameter.convertTo0to1(static_cast<float>(value)), 0); };
+    slider.setDoubleClickReturnValue(true, parameter.convertFrom0to1(parameter.getDefaultValue()));
+
+    throttledUpdate();
+
+    slider.addListener(this);
+    parameter.addListener(this);
+    throttler.addClient(this);
+}
+
+ThrottledSliderAttachment::~ThrottledSliderAttachment()
+{
+    throttler.removeClient(this);
+    parameter.removeListener(this);
+    slider.removeListener(this);
+}
+
+void ThrottledSliderAttachment::throttledUpdate()
+{
+    if (!updatePending.exchange(false))
+        return;
+
+    // Slider::setValue only repaints if the value actually moved
+    const juce::ScopedValueSetter<bool> ignoreChanges(ignoreSliderChanges, true);
+    slider.setValue(parameter.convertFrom0to1(parameter.getValue()), juce::sendNotificationSync);
+}
+
+void ThrottledSliderAttachment::sliderValueChanged(juce::Slider*)
+{
+    if (ignoreSliderChanges)
+        return;
+
+    parameter.setValueNotifyingHost(parameter.convertTo0to1(static_cast<float>(slider.getValue())));
+}
@@ -0,0 +1,70 @@
+// RepaintThrottler.h
+#pragma once
+
+#include <JuceHeader.h>
+
+// Caps how often an editor's controls follow parameter changes. Host automation can
+// move dozens of parameters every block; rather than each change posting its own
+// update and repaint, clients only note that something changed, and one timer per
+// editor brings them all up to date at most maxUpdatesPerSecond times a second.
+class RepaintThrottler : private juce::Timer
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+        virtual void throttledUpdate() = 0;
+    };
+
+    explicit RepaintThrottler(int maxUpdatesPerSecond = 30);
+    ~RepaintThrottler() override;
+
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+    // Brings every client up to date now, without waiting for the timer
+    void updateNow();
+
+private:
+    std::vector<Client*> clients;
+
+    void timerCallback() override { updateNow(); }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RepaintThrottler)
+};
+
+// Connects a slider to a parameter like AudioProcessorValueTreeState::SliderAttachment,
+// but parameter changes reach the slider through a RepaintThrottler. Changes made
+// with the slider go to the host straight away.
+class ThrottledSliderAttachment : public RepaintThrottler::Client,
+                                  private juce::Slider::Listener,
+                                  private juce::AudioProcessorParameter::Listener
+{
+public:
+    ThrottledSliderAttachment(juce::RangedAudioParameter& parameter, juce::Slider& slider, RepaintThrottler& throttler);
+    ~ThrottledSliderAttachment() override;
+
+    void throttledUpdate() override;
+
+    juce::RangedAudioParameter& getParameter() const { return parameter; }
+    juce::Slider& getSlider() const { return slider; }
+
+private:
+    juce::RangedAudioParameter& parameter;
+    juce::Slider& slider;
+    RepaintThrottler& throttler;
+
+    std::atomic<bool> updatePending { true };
+    bool ignoreSliderChanges = false;
+
+    void sliderValueChanged(juce::Slider*) override;
+    void sliderDragStarted(juce::Slider*) override { parameter.beginChangeGesture(); }
+    void sliderDragEnded(juce::Slider*) override { parameter.endChangeGesture(); }
+
+    // Any thread, so it only flags the slider for the next update
+    void parameterValueChanged(int, float) override { updatePending.store(true); }
+    void parameterGestureChanged(int, bool) override {}
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThrottledSliderAttachment)
+};
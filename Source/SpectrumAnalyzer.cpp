@@ -0,0 +1,147 @@
+// SpectrumAnalyzer.cpp
+#include "SpectrumAnalyzer.h"
+#include "FFT.h"
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+    recent.resize(static_cast<size_t>(fftSize));
+    fftData.resize(static_cast<size_t>(fftSize));
+    levels.assign(static_cast<size_t>(fftSize / 2), minDecibels);
+
+    // Hann
+    window.resize(static_cast<size_t>(fftSize));
+    float windowSum = 0.0f;
+    for (int i = 0; i < fftSize; ++i)
+    {
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / fftSize);
+        windowSum += window[static_cast<size_t>(i)];
+    }
+    windowGain = 2.0f / windowSum;
+
+    setInterceptsMouseClicks(false, false);
+}
+
+void SpectrumAnalyzer::pushSamples(const float* samples, int numSamples)
+{
+    // Only the newest fftSize samples matter
+    const int start = juce::jmax(0, numSamples - fftSize);
+    for (int i = start; i < numSamples; ++i)
+    {
+        recent[static_cast<size_t>(recentIndex)] = samples[i];
+        recentIndex = (recentIndex + 1) % fftSize;
+    }
+
+    hasNewSamples = hasNewSamples || numSamples > 0;
+}
+
+void SpectrumAnalyzer::update(double sampleRate)
+{
+    if (!hasNewSamples || sampleRate <= 0.0)
+        return;
+
+    hasNewSamples = false;
+    streamSampleRate = sampleRate;
+
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const auto index = static_cast<size_t>((recentIndex + i) % fftSize);
+        fftData[static_cast<size_t>(i)] = { recent[index] * window[static_cast<size_t>(i)], 0.0f };
+    }
+
+    FFT::transform(fftData);
+
+    for (size_t bin = 0; bin < levels.size(); ++bin)
+    {
+        const float decibels = juce::Decibels::gainToDecibels(std::abs(fftData[bin]) * windowGain, minDecibels);
+        levels[bin] = juce::jmax(decibels, levels[bin] - fallPerUpdate);
+    }
+
+    rebuildPath();
+    repaint();
+}
+
+//==============================================================================
+float SpectrumAnalyzer::frequencyToX(float frequency) const
+{
+    const float nyquist = static_cast<float>(streamSampleRate * 0.5);
+    return getWidth() * std::log(frequency / minFrequency) / std::log(nyquist / minFrequency);
+}
+
+float SpectrumAnalyzer::decibelsToY(float decibels) const
+{
+    return juce::jmap(juce::jlimit(minDecibels, maxDecibels, decibels), maxDecibels, minDecibels, 0.0f, static_cast<float>(getHeight()));
+}
+
+void SpectrumAnalyzer::rebuildPath()
+{
+    curve.clear();
+    fill.clear();
+
+    const int width = getWidth();
+    const float nyquist = static_cast<float>(streamSampleRate * 0.5);
+    if (width <= 0 || nyquist <= minFrequency)
+        return;
+
+    // One point every two pixels. Where a step covers several bins (the top octaves)
+    // it takes their maximum so narrow peaks don't vanish between points.
+    const float binsPerHz = fftSize / static_cast<float>(streamSampleRate);
+    const float logSpan = std::log(nyquist / minFrequency);
+    const int lastBin = fftSize / 2 - 1;
+
+    for (int x = 0; x <= width; x += 2)
+    {
+        const float lowBin = minFrequency * std::exp(logSpan * x / width) * binsPerHz;
+        const float highBin = minFrequency * std::exp(logSpan * (x + 2) / width) * binsPerHz;
+
+        float decibels = minDecibels;
+        if (highBin - lowBin < 1.0f)
+        {
+            const int bin = juce::jlimit(0, lastBin - 1, static_cast<int>(lowBin));
+            const float fraction = juce::jlimit(0.0f, 1.0f, lowBin - static_cast<float>(bin));
+            decibels = levels[static_cast<size_t>(bin)] + fraction * (levels[static_cast<size_t>(bin + 1)] - levels[static_cast<size_t>(bin)]);
+        }
+        else
+        {
+            for (int bin = static_cast<int>(lowBin); bin < juce::jmin(static_cast<int>(highBin), lastBin + 1); ++bin)
+                decibels = juce::jmax(decibels, levels[static_cast<size_t>(bin)]);
+        }
+
+        const float y = decibelsToY(decibels);
+        if (x == 0)
+            curve.startNewSubPath(0.0f, y);
+        else
+            curve.lineTo(static_cast<float>(x), y);
+    }
+
+    fill = curve;
+    fill.lineTo(static_cast<float>(width), static_cast<float>(getHeight()));
+    fill.lineTo(0.0f, static_cast<float>(getHeight()));
+    fill.closeSubPath();
+}
+
+void SpectrumAnalyzer::resized()
+{
+    rebuildPath();
+}
+
+void SpectrumAnalyzer::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xff2c3e50).darker(0.3f));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    // Decades
+    if (streamSampleRate > 0.0)
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.3f));
+        for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+            if (frequency < streamSampleRate * 0.5)
+                g.drawVerticalLine(juce::roundToInt(frequencyToX(frequency)), 0.0f, bounds.getHeight());
+    }
+
+    const auto accent = juce::Colour(0xfff39c12);
+    g.setColour(accent.withAlpha(0.25f));
+    g.fillPath(fill);
+    g.setColour(accent);
+    g.strokePath(curve, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,54 @@
+// SpectrumAnalyzer.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include <vector>
+
+// Output spectrum on a log frequency axis. Samples come from Telemetry through the
+// editor's timer, and the FFT runs there too, once per tick on the newest fftSize
+// samples; the audio thread only ever copies samples into the FIFO.
+//
+// Levels fall back slowly so transients stay readable. The curve is rebuilt after
+// each transform and only filled and stroked in paint().
+class SpectrumAnalyzer : public juce::Component
+{
+public:
+    SpectrumAnalyzer();
+
+    void pushSamples(const float* samples, int numSamples);
+
+    // Transforms and rebuilds the curve if samples arrived since the last call.
+    // sampleRate is that of the Telemetry stream, after decimation.
+    void update(double sampleRate);
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float minDecibels = -90.0f;
+    static constexpr float maxDecibels = 0.0f;
+    static constexpr float fallPerUpdate = 1.5f;    // dB per tick
+
+    std::vector<float> recent;                      // Ring of the newest fftSize samples
+    int recentIndex = 0;
+    bool hasNewSamples = false;
+
+    std::vector<float> window;
+    float windowGain = 1.0f;                        // Full-scale sine reads 0 dB
+    std::vector<std::complex<float>> fftData;
+    std::vector<float> levels;                      // dB per bin, with the fall applied
+    double streamSampleRate = 0.0;
+
+    juce::Path curve;
+    juce::Path fill;
+
+    float frequencyToX(float frequency) const;
+    float decibelsToY(float decibels) const;
+    void rebuildPath();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
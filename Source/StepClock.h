@@ -0,0 +1,90 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// The step clock shared by Arpeggiator and StepSequencer. Positions are in quarter
+// notes: step k starts at k * stepBeats, odd steps later by the swing offset (a swing
+// of 1 delays them by a third of a step). Each block is placed on the clock with
+// beginBlock(), then forEachStep() visits the steps starting in it that haven't
+// played yet; lastStepIndex stops a step firing twice across blocks. Audio thread.
+class StepClock
+{
+public:
+    void reset() noexcept
+    {
+        internalPosition = 0.0;
+        lastStepIndex = -1;
+    }
+
+    // Places the next numSamples on the clock: at hostPosition when following the host,
+    // otherwise on the internal clock, which carries on from where the last block ended
+    void beginBlock(bool followHost, double hostPosition, double newBeatsPerSample,
+                    double newStepBeats, float newSwing, int newNumSamples) noexcept
+    {
+        beatsPerSample = newBeatsPerSample;
+        stepBeats = newStepBeats;
+        swing = newSwing;
+        numSamples = newNumSamples;
+        blockStart = followHost ? hostPosition : internalPosition;
+        blockEnd = blockStart + numSamples * beatsPerSample;
+        internalPosition = blockEnd; // Also where the internal clock carries on if the host stops
+    }
+
+    double getBlockStart() const noexcept { return blockStart; }
+    double getBlockEnd() const noexcept { return blockEnd; }
+    double getBeatsPerSample() const noexcept { return beatsPerSample; }
+    double getStepBeats() const noexcept { return stepBeats; }
+
+    int toSampleOffset(double position) const noexcept
+    {
+        return juce::jlimit(0, numSamples - 1, static_cast<int>((position - blockStart) / beatsPerSample));
+    }
+
+    // Unswung grid step the position falls in
+    juce::int64 getStepIndexAt(double position) const noexcept
+    {
+        return static_cast<juce::int64>(std::floor(position / stepBeats));
+    }
+
+    double getStepStart(juce::int64 stepIndex) const noexcept
+    {
+        const double start = static_cast<double>(stepIndex) * stepBeats;
+        return (stepIndex & 1) != 0 ? start + swing * stepBeats / 3.0 : start;
+    }
+
+    // Steps up to and including stepIndex count as played
+    juce::int64 getLastStepIndex() const noexcept { return lastStepIndex; }
+    void setLastStepIndex(juce::int64 stepIndex) noexcept { lastStepIndex = stepIndex; }
+
+    // Calls onStep(stepIndex, stepStart, stepLength) for each step starting in this
+    // block, in order, and marks it played
+    template <typename Callback>
+    void forEachStep(Callback&& onStep)
+    {
+        // A swung odd step may start after the following grid line, so start one step
+        // early and skip what's already past
+        for (auto stepIndex = getStepIndexAt(blockStart) - 1;; ++stepIndex) {
+            const double stepStart = getStepStart(stepIndex);
+            if (stepStart >= blockEnd) {
+                break;
+            }
+            // Up to a sample early still counts, in case rounding put it just before the block
+            if (stepStart < blockStart - beatsPerSample || stepIndex <= lastStepIndex) {
+                continue;
+            }
+
+            lastStepIndex = stepIndex;
+            onStep(stepIndex, stepStart, getStepStart(stepIndex + 1) - stepStart);
+        }
+    }
+
+private:
+    double internalPosition = 0.0;
+    double blockStart = 0.0;
+    double blockEnd = 0.0;
+    double beatsPerSample = 0.0;
+    double stepBeats = 0.25;
+    float swing = 0.0f;
+    int numSamples = 0;
+    juce::int64 lastStepIndex = -1;
+};
@@ -0,0 +1,299 @@
+#include "StepSequencer.h"
+
+StepSequencer::StepSequencer()
+{
+    resetState();
+    recordStart.fill(-1.0);
+}
+
+void StepSequencer::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    stepClock.reset();
+    clockRunning = false;
+    numScheduled = 0;
+    recordStart.fill(-1.0);
+}
+
+void StepSequencer::process(const juce::MidiBuffer& midiMessages, juce::MidiBuffer& outputBuffer, int numSamples)
+{
+    if (!isEnabled.load()) {
+        flushNoteOffs(outputBuffer, 0);
+        clockRunning = false;
+        currentStep.store(-1);
+        modulationValue = 0.0f; // Lets go of whatever the lane was modulating
+        return;
+    }
+
+    // Where this block sits on the step clock: the host's PPQ while it plays, otherwise
+    // the internal clock at the host tempo
+    const double stepBeats = Arpeggiator::getDivisionBeats(division.load());
+    stepClock.beginBlock(hostIsPlaying, hostPPQ, hostBPM / (60.0 * sampleRate), stepBeats, swing.load(), numSamples);
+    const double blockStart = stepClock.getBlockStart();
+    const double blockEnd = stepClock.getBlockEnd();
+
+    // The clock jumped (first block, relocation, loop, transport start or stop): end
+    // what's sounding and carry on from the new position
+    if (!clockRunning || std::abs(blockStart - expectedPosition) > 0.5 * stepBeats) {
+        flushNoteOffs(outputBuffer, 0);
+        stepClock.setLastStepIndex(stepClock.getStepIndexAt(blockStart) - 1);
+        clockRunning = true;
+    }
+    expectedPosition = blockEnd;
+
+    if (isRecording.load()) {
+        record(midiMessages);
+    }
+
+    stepClock.forEachStep([this](juce::int64 stepIndex, double stepStart, double stepLength) {
+        scheduleStep(stepIndex, stepStart, stepLength);
+    });
+
+    // Everything due in this block, already in time order
+    int numDue = 0;
+    for (; numDue < numScheduled && scheduled[static_cast<size_t>(numDue)].position < blockEnd; ++numDue) {
+        const auto& event = scheduled[static_cast<size_t>(numDue)];
+        const int sampleOffset = stepClock.toSampleOffset(event.position);
+        if (event.velocity > 0) {
+            outputBuffer.addEvent(juce::MidiMessage::noteOn(1, event.note, event.velocity), sampleOffset);
+        } else {
+            outputBuffer.addEvent(juce::MidiMessage::noteOff(1, event.note), sampleOffset);
+        }
+    }
+
+    std::copy(scheduled.begin() + numDue, scheduled.begin() + numScheduled, scheduled.begin());
+    numScheduled -= numDue;
+}
+
+void StepSequencer::setTransportPosition(double bpm, double ppqPosition, bool isPlaying)
+{
+    hostBPM = bpm > 0.0 ? bpm : 120.0;
+    hostPPQ = ppqPosition;
+    hostIsPlaying = isPlaying;
+}
+
+void StepSequencer::scheduleStep(juce::int64 stepIndex, double stepStart, double stepLength)
+{
+    modulationValue = getLaneValue(MODULATION_LANE, stepIndex);
+    currentStep.store(getLaneStep(NOTE_LANE, stepIndex));
+
+    const int note = juce::roundToInt(getLaneValue(NOTE_LANE, stepIndex));
+    if (note < 0 || stepIndex == skipStepIndex) {
+        return;
+    }
+
+    const int velocity = juce::roundToInt(getLaneValue(VELOCITY_LANE, stepIndex));
+    const float gate = getLaneValue(GATE_LANE, stepIndex);
+    const int numHits = juce::roundToInt(getLaneValue(RATCHET_LANE, stepIndex));
+
+    // Ratchets split the step into equal hits, each with the step's gate
+    const double hitLength = stepLength / numHits;
+    for (int hit = 0; hit < numHits; ++hit) {
+        const double hitStart = stepStart + hit * hitLength;
+        schedule(hitStart, note, velocity);
+        schedule(hitStart + gate * hitLength, note, 0);
+    }
+}
+
+void StepSequencer::schedule(double position, int note, int velocity)
+{
+    // A note-on needs room for its note-off too, so a full queue never leaves a note hanging
+    if (numScheduled >= maxScheduledEvents - (velocity > 0 ? 1 : 0)) {
+        return;
+    }
+
+    // After every event due earlier; at the same position note-offs go first, so a
+    // full gate ending on the next hit of the same note doesn't cut that hit off
+    int insertAt = numScheduled;
+    while (insertAt > 0) {
+        const auto& previous = scheduled[static_cast<size_t>(insertAt - 1)];
+        if (previous.position < position || (previous.position == position && (velocity > 0 || previous.velocity == 0))) {
+            break;
+        }
+        --insertAt;
+    }
+
+    std::copy_backward(scheduled.begin() + insertAt, scheduled.begin() + numScheduled,
+                       scheduled.begin() + numScheduled + 1);
+    scheduled[static_cast<size_t>(insertAt)] = { position, static_cast<juce::uint8>(note), static_cast<juce::uint8>(velocity) };
+    ++numScheduled;
+}
+
+void StepSequencer::record(const juce::MidiBuffer& midiMessages)
+{
+    const double stepBeats = stepClock.getStepBeats();
+    for (const auto metadata : midiMessages) {
+        const auto message = metadata.getMessage();
+        const double position = stepClock.getBlockStart() + metadata.samplePosition * stepClock.getBeatsPerSample();
+        const int note = message.getNoteNumber();
+
+        if (message.isNoteOn()) {
+            // Quantised to the nearest step on the unswung grid
+            const auto stepIndex = static_cast<juce::int64>(std::floor(position / stepBeats + 0.5));
+            setStepValue(NOTE_LANE, getLaneStep(NOTE_LANE, stepIndex), static_cast<float>(note));
+            setStepValue(VELOCITY_LANE, getLaneStep(VELOCITY_LANE, stepIndex), static_cast<float>(message.getVelocity()));
+            recordStart[static_cast<size_t>(note)] = position;
+            recordStep[static_cast<size_t>(note)] = stepIndex;
+
+            if (stepIndex > stepClock.getLastStepIndex()) {
+                skipStepIndex = stepIndex;
+            }
+        } else if (message.isNoteOff() && recordStart[static_cast<size_t>(note)] >= 0.0) {
+            const auto stepIndex = recordStep[static_cast<size_t>(note)];
+            const double heldSteps = (position - recordStart[static_cast<size_t>(note)]) / stepBeats;
+            setStepValue(GATE_LANE, getLaneStep(GATE_LANE, stepIndex), static_cast<float>(heldSteps));
+            recordStart[static_cast<size_t>(note)] = -1.0;
+        }
+    }
+}
+
+void StepSequencer::flushNoteOffs(juce::MidiBuffer& buffer, int sampleOffset)
+{
+    // Note-offs whose note-on already went out; pairs that are both still to come are dropped
+    std::array<juce::uint64, 2> pendingOns {};
+    for (int i = 0; i < numScheduled; ++i) {
+        const auto& event = scheduled[static_cast<size_t>(i)];
+        auto& word = pendingOns[static_cast<size_t>(event.note >> 6)];
+        const auto bit = juce::uint64(1) << (event.note & 63);
+
+        if (event.velocity > 0) {
+            word |= bit;
+        } else if ((word & bit) != 0) {
+            word &= ~bit;
+        } else {
+            buffer.addEvent(juce::MidiMessage::noteOff(1, event.note), sampleOffset);
+        }
+    }
+    numScheduled = 0;
+}
+
+int StepSequencer::getLaneStep(Lane lane, juce::int64 stepIndex) const
+{
+    // Positive modulo, the PPQ position (and so the step index) can be negative in a pre-roll
+    const auto length = static_cast<juce::int64>(getLaneLength(lane));
+    return static_cast<int>(((stepIndex % length) + length) % length);
+}
+
+float StepSequencer::getLaneValue(Lane lane, juce::int64 stepIndex) const
+{
+    return lanes[static_cast<size_t>(lane)][static_cast<size_t>(getLaneStep(lane, stepIndex))].load(std::memory_order_relaxed);
+}
+
+void StepSequencer::setStepValue(Lane lane, int step, float value)
+{
+    if (step < 0 || step >= maxSteps) {
+        return;
+    }
+
+    switch (lane) {
+        case NOTE_LANE:     value = static_cast<float>(juce::jlimit(-1, 127, juce::roundToInt(value))); break;
+        case VELOCITY_LANE: value = static_cast<float>(juce::jlimit(1, 127, juce::roundToInt(value))); break;
+        case GATE_LANE:     value = juce::jlimit(0.05f, 1.0f, value); break;
+        case RATCHET_LANE:  value = static_cast<float>(juce::jlimit(1, maxRatchet, juce::roundToInt(value))); break;
+        case MODULATION_LANE: value = juce::jlimit(-1.0f, 1.0f, value); break;
+        default: return;
+    }
+
+    lanes[static_cast<size_t>(lane)][static_cast<size_t>(step)].store(value, std::memory_order_relaxed);
+}
+
+float StepSequencer::getStepValue(Lane lane, int step) const
+{
+    if (lane < 0 || lane >= LANE_COUNT || step < 0 || step >= maxSteps) {
+        return 0.0f;
+    }
+    return lanes[static_cast<size_t>(lane)][static_cast<size_t>(step)].load(std::memory_order_relaxed);
+}
+
+void StepSequencer::setLaneLength(Lane lane, int numSteps)
+{
+    if (lane >= 0 && lane < LANE_COUNT) {
+        laneLengths[static_cast<size_t>(lane)].store(juce::jlimit(1, maxSteps, numSteps));
+    }
+}
+
+int StepSequencer::getLaneLength(Lane lane) const
+{
+    return laneLengths[static_cast<size_t>(lane)].load(std::memory_order_relaxed);
+}
+
+void StepSequencer::setLength(int numSteps)
+{
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        setLaneLength(static_cast<Lane>(lane), numSteps);
+    }
+}
+
+void StepSequencer::resetState()
+{
+    clear();
+    setLength(16);
+}
+
+void StepSequencer::clear()
+{
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        for (auto& step : lanes[static_cast<size_t>(lane)]) {
+            step.store(getDefaultValue(static_cast<Lane>(lane)));
+        }
+    }
+}
+
+void StepSequencer::writeState(juce::MemoryBlock& destData) const
+{
+    juce::MemoryOutputStream out(destData, false);
+    out.writeInt(1); // Version
+    out.writeInt(LANE_COUNT);
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        out.writeInt(getLaneLength(static_cast<Lane>(lane)));
+        out.writeInt(maxSteps);
+        for (int step = 0; step < maxSteps; ++step) {
+            out.writeFloat(getStepValue(static_cast<Lane>(lane), step));
+        }
+    }
+
+    out.flush();
+    destData.setSize(out.getDataSize());
+}
+
+bool StepSequencer::restoreState(const void* data, size_t sizeInBytes)
+{
+    juce::MemoryInputStream in(data, sizeInBytes, false);
+    const int version = in.readInt();
+    const int numLanes = in.readInt();
+    if (version < 1 || numLanes < 0) {
+        return false;
+    }
+
+    // Lanes and steps a newer version added are skipped
+    clear();
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const int length = in.readInt();
+        const int numSteps = in.readInt();
+        if (numSteps < 0 || in.getNumBytesRemaining() < static_cast<juce::int64>(numSteps) * 4) {
+            return false; // Truncated
+        }
+
+        for (int step = 0; step < numSteps; ++step) {
+            const float value = in.readFloat();
+            if (lane < LANE_COUNT) {
+                setStepValue(static_cast<Lane>(lane), step, value);
+            }
+        }
+        if (lane < LANE_COUNT) {
+            setLaneLength(static_cast<Lane>(lane), length);
+        }
+    }
+    return true;
+}
+
+float StepSequencer::getDefaultValue(Lane lane)
+{
+    switch (lane) {
+        case NOTE_LANE:     return -1.0f;
+        case VELOCITY_LANE: return 100.0f;
+        case GATE_LANE:     return 0.5f;
+        case RATCHET_LANE:  return 1.0f;
+        default:            return 0.0f;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Arpeggiator.h"
+#include "StepClock.h"
+
+// Monophonic 64-step sequencer. Every step has a value in each lane, and each lane
+// has its own length, so e.g. a 16-step note lane against a 12-step velocity lane
+// makes a 48-step cycle. Steps are locked to the host's PPQ position while it plays
+// and follow an internal clock at the last known tempo while it's stopped.
+//
+// Lanes can be edited from any thread while the sequencer runs; process() and
+// setTransportPosition() belong to the audio thread and never allocate.
+class StepSequencer
+{
+public:
+    static constexpr int maxSteps = 64;
+    static constexpr int maxRatchet = 8;
+
+    enum Lane {
+        NOTE_LANE = 0,      // MIDI note number, -1 is a rest
+        VELOCITY_LANE,      // 1-127
+        GATE_LANE,          // Fraction of the step (or of each ratchet hit), 0.05-1
+        RATCHET_LANE,       // Hits per step, 1-8
+        MODULATION_LANE,    // -1 to 1, the ModulationMatrix Sequencer source
+        LANE_COUNT
+    };
+
+    StepSequencer();
+
+    void prepare(double sampleRate);
+
+    // Adds the sequence's notes to outputBuffer. While recording, note-ons in
+    // midiMessages are written into the nearest step, and the time until their
+    // note-off into its gate; midiMessages itself is left alone.
+    void process(const juce::MidiBuffer& midiMessages, juce::MidiBuffer& outputBuffer, int numSamples);
+
+    // Call once per block before process()
+    void setTransportPosition(double bpm, double ppqPosition, bool isPlaying);
+
+    void setEnabled(bool enabled) { isEnabled.store(enabled); }
+    void setRecording(bool shouldRecord) { isRecording.store(shouldRecord); }
+    void setDivision(Arpeggiator::Division newDivision) { division.store(newDivision); }
+    void setSwing(float amount) { swing.store(juce::jlimit(0.0f, 1.0f, amount)); } // 1 delays every other step by a third
+
+    void setStepValue(Lane lane, int step, float value);
+    float getStepValue(Lane lane, int step) const;
+    void setLaneLength(Lane lane, int numSteps);
+    int getLaneLength(Lane lane) const;
+    void setLength(int numSteps); // Every lane
+    void clear();                 // Rests everywhere, other lanes back to their defaults
+    void resetState();            // Cleared with 16 steps, as a new sequencer
+
+    static float getDefaultValue(Lane lane);
+
+    // The lanes and their lengths, for a BinaryState chunk (enable, record, division and
+    // swing are the processor's parameters). Message thread.
+    static constexpr juce::uint32 stateChunkTag = 0x50455453; // "STEP"
+    void writeState(juce::MemoryBlock& destData) const;
+    bool restoreState(const void* data, size_t sizeInBytes);
+
+    // Note lane step playing now, for an editor's playhead; -1 before the first step
+    int getCurrentStep() const { return currentStep.load(); }
+
+    // Modulation lane value of the latest step, held until the next one
+    float getModulationValue() const { return modulationValue; }
+
+private:
+    std::array<std::array<std::atomic<float>, maxSteps>, LANE_COUNT> lanes;
+    std::array<std::atomic<int>, LANE_COUNT> laneLengths;
+
+    std::atomic<bool> isEnabled { false };
+    std::atomic<bool> isRecording { false };
+    std::atomic<Arpeggiator::Division> division { Arpeggiator::SIXTEENTH };
+    std::atomic<float> swing { 0.0f };
+    std::atomic<int> currentStep { -1 };
+
+    double sampleRate = 44100.0;
+    double hostBPM = 120.0;
+    double hostPPQ = 0.0;
+    bool hostIsPlaying = false;
+
+    // expectedPosition is where the next block should start on the step clock; anything
+    // else is a relocation, loop or transport start
+    StepClock stepClock;
+    double expectedPosition = 0.0;
+    bool clockRunning = false;
+    juce::int64 skipStepIndex = -1; // Just recorded into, so the live note isn't doubled
+    float modulationValue = 0.0f;
+
+    // Note-ons and note-offs of the steps played so far that are still to come, in
+    // time order. A step is scheduled whole when it starts, so gates and ratchet hits
+    // can run past the end of the block; each block then only visits its events.
+    struct ScheduledEvent
+    {
+        double position = 0.0;  // Step clock
+        juce::uint8 note = 0;
+        juce::uint8 velocity = 0; // 0 = note-off
+    };
+    static constexpr int maxScheduledEvents = 256;
+    std::array<ScheduledEvent, maxScheduledEvents> scheduled {};
+    int numScheduled = 0;
+
+    // Recording: where each held input note started and which step it went into
+    std::array<double, 128> recordStart {};
+    std::array<juce::int64, 128> recordStep {};
+
+    int getLaneStep(Lane lane, juce::int64 stepIndex) const;
+    float getLaneValue(Lane lane, juce::int64 stepIndex) const;
+    void scheduleStep(juce::int64 stepIndex, double stepStart, double stepLength);
+    void schedule(double position, int note, int velocity);
+    void record(const juce::MidiBuffer& midiMessages);
+    void flushNoteOffs(juce::MidiBuffer& buffer, int sampleOffset);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StepSequencer)
+};
@@ -11,38 +11,43 @@ void StereoDelay::prepare(double newSampleRate, int samplesPerBlock)
     delayBuffer.setSize(2, bufferSize);
     delayBuffer.clear();
     
-    writePosition = 0;
+    writePositions.fill(0);
     updateDelayTime();
 }
 
 void StereoDelay::process(juce::AudioBuffer<float>& buffer)
 {
-    if (!isEnabled) return;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        processChannel(buffer, channel);
+    }
+}
+
+void StereoDelay::processChannel(juce::AudioBuffer<float>& buffer, int channel)
+{
+    if (!isEnabled || channel >= delayBuffer.getNumChannels()) return;
     
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
     const int bufferSize = delayBuffer.getNumSamples();
     
-    for (int channel = 0; channel < numChannels; ++channel) {
-        float* channelData = buffer.getWritePointer(channel);
-        float* delayData = delayBuffer.getWritePointer(channel);
+    float* channelData = buffer.getWritePointer(channel);
+    float* delayData = delayBuffer.getWritePointer(channel);
+    int& writePosition = writePositions[static_cast<size_t>(channel)];
+    
+    int readPosition = (writePosition - delayTimeSamples + bufferSize) % bufferSize;
+    
+    for (int i = 0; i < numSamples; ++i) {
+        const float in = channelData[i];
+        const float delaySample = delayData[readPosition];
+        
+        // Write to delay buffer
+        delayData[writePosition] = in + (delaySample * feedback);
         
-        int readPosition = (writePosition - delayTimeSamples + bufferSize) % bufferSize;
+        // Mix dry and wet
+        channelData[i] = (in * (1.0f - mix)) + (delaySample * mix);
         
-        for (int i = 0; i < numSamples; ++i) {
-            const float in = channelData[i];
-            const float delaySample = delayData[readPosition];
-            
-            // Write to delay buffer
-            delayData[writePosition] = in + (delaySample * feedback);
-            
-            // Mix dry and wet
-            channelData[i] = (in * (1.0f - mix)) + (delaySample * mix);
-            
-            // Update positions
-            readPosition = (readPosition + 1) % bufferSize;
-            writePosition = (writePosition + 1) % bufferSize;
-        }
+        // Update positions
+        readPosition = (readPosition + 1) % bufferSize;
+        writePosition = (writePosition + 1) % bufferSize;
     }
 }
 
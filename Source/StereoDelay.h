@@ -9,6 +9,7 @@ public:
     
     void prepare(double sampleRate, int samplesPerBlock);
     void process(juce::AudioBuffer<float>& buffer);
+    void processChannel(juce::AudioBuffer<float>& buffer, int channel); // Channels are independent
     
     void setEnabled(bool enabled) { isEnabled = enabled; }
     void setDelayTime(float timeMs);
@@ -26,7 +27,8 @@ private:
     bool syncToHost = false;
     
     double sampleRate = 44100.0;
-    int writePosition = 0;
+    int delayTimeSamples = 1;
+    std::array<int, 2> writePositions {}; // Per channel, so channels can run on different threads
     
     juce::AudioBuffer<float> delayBuffer;
     
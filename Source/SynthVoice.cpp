@@ -1,6 +1,7 @@
 // SynthVoice.cpp
 #include "SynthVoice.h"
 #include "SynthSound.h"
+#include "VoiceAllocator.h"
 #include <cmath>
 
 SynthVoice::SynthVoice()
@@ -10,6 +11,8 @@ SynthVoice::SynthVoice()
     modMatrix.setLFO2(&lfo2);
     modMatrix.setFilterEnv(&filterEnvelope);
     modMatrix.setAmpEnv(&ampEnvelope);
+    setOscillatorPWM(0.5f);
+    setOscillator2PWM(0.5f);
 
     // Set default envelope times
     setAmpAttackTime(50.0f);
@@ -42,29 +45,23 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity,
                           juce::SynthesiserSound* sound, int currentPitchWheelPosition)
 {
     juce::ignoreUnused(sound);
-    
-    currentNoteNumber = midiNoteNumber;
-    currentVelocity = velocity;
-    isNotePlaying = true;
-    isTailOff = false;
-
-    // Convert pitch wheel to bend amount (-2 to +2 semitones)
-    currentPitchBend = (currentPitchWheelPosition - 8192) / 8192.0f * 2.0f;
 
-    // Calculate frequency
-    float frequency = calculateFrequency(midiNoteNumber, currentPitchBend);
-    oscillator.setFrequency(frequency);
+    if (voiceAllocator != nullptr)
+        voiceAllocator->voiceStarted(voiceIndex);
 
-    // Trigger envelopes
-    ampEnvelope.noteOn();
-    filterEnvelope.noteOn();
-
-    // Reset LFOs
-    lfo1.reset();
-    lfo2.reset();
+    // A stolen voice is still fading out its previous note; start once it is silent
+    if (killFadeSamplesRemaining > 0)
+    {
+        hasPendingNote = true;
+        pendingNoteNumber = midiNoteNumber;
+        pendingVelocity = velocity;
+        pendingPitchWheel = currentPitchWheelPosition;
+        isNotePlaying = true;
+        isTailOff = false;
+        return;
+    }
 
-    // Update modulation matrix with velocity
-    modMatrix.setVelocity(velocity);
+    triggerNote(midiNoteNumber, velocity, currentPitchWheelPosition);
 }
 
 void SynthVoice::stopNote(float velocity, bool allowTailOff)
@@ -72,6 +69,7 @@ void SynthVoice::stopNote(float velocity, bool allowTailOff)
     juce::ignoreUnused(velocity);
     
     isNotePlaying = false;
+    hasPendingNote = false;
 
     if (allowTailOff)
     {
@@ -81,7 +79,19 @@ void SynthVoice::stopNote(float velocity, bool allowTailOff)
     }
     else
     {
-        clearCurrentNote();
+        // Ramp out over a few milliseconds rather than cutting the output dead
+        if (ampEnvelope.isActive() && killFadeSamplesRemaining == 0)
+            killFadeSamplesRemaining = killFadeLength;
+
+        isTailOff = false;
+
+        // A fading voice only goes back on the free list once it is silent (see
+        // finishKillFade), so the next note goes to an idle voice rather than
+        // waiting out the fade on this one
+        if (killFadeSamplesRemaining > 0)
+            clearCurrentNote();
+        else
+            releaseVoice();
     }
 }
 
@@ -113,24 +123,66 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
                                 int startSample, int numSamples)
 {
     if (!isActive())
+    {
+        // Keep the LFOs moving so a transport-locked one is in phase when a note starts mid-block
+        lfo1.skipSamples(numSamples);
+        lfo2.skipSamples(numSamples);
+        outputLevel = 0.0f;
         return;
+    }
+
+    float blockPeak = 0.0f;
+    const int numChannels = outputBuffer.getNumChannels();
+    const bool stereoOutput = oscillatorSlots[0].oscillator.isStereo();
 
     // Process each sample
     for (int sample = 0; sample < numSamples; ++sample)
     {
-        // Generate oscillator output
-        float oscOutput = oscillator.process();
+        // Portamento
+        if (isGliding)
+        {
+            currentPitch += (targetPitch - currentPitch) * glideCoeff;
+            if (std::abs(targetPitch - currentPitch) < 0.001f)
+            {
+                currentPitch = targetPitch;
+                isGliding = false;
+            }
+            oscillatorSlots[0].oscillator.setFrequency(calculateFrequency(currentPitch, currentPitchBend));
+        }
 
-        // Get envelope values
+        // Get LFO and envelope values
+        float lfo1Value = lfo1.getNextSample();
+        float lfo2Value = lfo2.getNextSample();
         float ampEnvValue = ampEnvelope.getNextSample();
         float filterEnvValue = filterEnvelope.getNextSample();
 
-        // Get LFO values
-        float lfo1Value = lfo1.getNextSample();
-        float lfo2Value = lfo2.getNextSample();
+        // Pulse widths come from the modulation matrix sample by sample
+        const ModulationMatrix::SampleSources sources { lfo1Value, lfo2Value, filterEnvValue, ampEnvValue };
+        const float pulseWidth1 = modMatrix.getModulatedValue(ModulationMatrix::Osc1PWM, sources);
+        const float pulseWidth2 = modMatrix.getModulatedValue(ModulationMatrix::Osc2PWM, sources);
+
+        // Generate oscillator output
+        float oscLeft = 0.0f;
+        float oscRight = 0.0f;
+        for (int slotIndex = 0; slotIndex < numOscillatorSlots; ++slotIndex)
+        {
+            auto& slot = oscillatorSlots[static_cast<size_t>(slotIndex)];
+            if (slot.noteNumber < 0)
+                continue;
+
+            float slotLeft, slotRight;
+            slot.oscillator.process(slotLeft, slotRight, pulseWidth1, pulseWidth2);
+
+            slot.gain += (slot.gainTarget - slot.gain) * slotGainCoeff;
+            oscLeft += slotLeft * slot.gain;
+            oscRight += slotRight * slot.gain;
 
-        // Calculate modulated filter cutoff
-        float modulatedCutoff = baseFilterCutoff;
+            if (slot.gainTarget == 0.0f && slot.gain < 1.0e-4f)
+                slot.noteNumber = -1;
+        }
+
+        // Calculate modulated filter cutoff, starting from the matrix's routings
+        float modulatedCutoff = modMatrix.getModulatedValue(ModulationMatrix::FilterCutoff, sources);
         modulatedCutoff += filterEnvValue * filterEnvAmount * 5000.0f;
         modulatedCutoff += lfo1Value * lfo1ToFilterAmount * 3000.0f;
         modulatedCutoff += lfo2Value * lfo2ToFilterAmount * 3000.0f;
@@ -138,25 +190,51 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
         modulatedCutoff += currentVelocity * velocityToFilterAmount * 3000.0f;
         modulatedCutoff = juce::jlimit(20.0f, 20000.0f, modulatedCutoff);
 
-        // Apply filter
+        // Apply filter; the right channel only needs its own ladder when the unison stack is spread
         filter.setCutoff(modulatedCutoff);
-        float filteredOutput = filter.processSample(oscOutput);
+        float filteredLeft = filter.processSample(oscLeft);
+        float filteredRight = filteredLeft;
+        if (stereoOutput)
+        {
+            filterRight.matchCoefficients(filter);
+            filteredRight = filterRight.processSample(oscRight);
+        }
 
         // Apply amplitude envelope and velocity
         float velocityScale = 1.0f - velocityToAmpAmount + (currentVelocity * velocityToAmpAmount);
-        float finalOutput = filteredOutput * ampEnvValue * velocityScale * masterVolume;
+        float gain = ampEnvValue * velocityScale * masterVolume;
+
+        if (killFadeSamplesRemaining > 0)
+        {
+            gain *= static_cast<float>(killFadeSamplesRemaining) / static_cast<float>(killFadeLength);
+            if (--killFadeSamplesRemaining == 0)
+                finishKillFade();
+        }
 
-        // Mix into output buffer (stereo)
-        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+        const float outputLeft = filteredLeft * gain;
+        const float outputRight = filteredRight * gain;
+
+        blockPeak = juce::jmax(blockPeak, std::abs(outputLeft), std::abs(outputRight));
+
+        // Mix into output buffer
+        if (numChannels > 1)
+        {
+            outputBuffer.addSample(0, startSample + sample, outputLeft);
+            outputBuffer.addSample(1, startSample + sample, outputRight);
+        }
+        else if (numChannels == 1)
         {
-            outputBuffer.addSample(channel, startSample + sample, finalOutput);
+            outputBuffer.addSample(0, startSample + sample, 0.5f * (outputLeft + outputRight));
         }
     }
 
+    outputLevel = blockPeak;
+
     // Check if voice should be released
     if (isTailOff && !ampEnvelope.isActive())
     {
-        clearCurrentNote();
+        isTailOff = false;
+        releaseVoice();
     }
 }
 
@@ -164,48 +242,189 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
 // Parameter setters
 void SynthVoice::setSampleRate(double newSampleRate)
 {
-    oscillator.setSampleRate(static_cast<float>(newSampleRate));
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setSampleRate(static_cast<float>(newSampleRate));
     ampEnvelope.setSampleRate(static_cast<float>(newSampleRate));
     filterEnvelope.setSampleRate(static_cast<float>(newSampleRate));
     filter.setSampleRate(static_cast<float>(newSampleRate));
+    filterRight.setSampleRate(static_cast<float>(newSampleRate));
     lfo1.setSampleRate(newSampleRate);
     lfo2.setSampleRate(newSampleRate);
+
+    killFadeLength = juce::jmax(1, static_cast<int>(newSampleRate * killFadeTimeMs * 0.001));
+
+    // Paraphonic notes fade in and out over ~5ms
+    voiceSampleRate = static_cast<float>(newSampleRate);
+    slotGainCoeff = 1.0f - std::exp(-1.0f / (0.005f * voiceSampleRate));
+    updateGlideCoefficient();
+}
+
+void SynthVoice::setVoiceAllocator(VoiceAllocator* allocator, int index)
+{
+    voiceAllocator = allocator;
+    voiceIndex = index;
+
+    // Free-running LFOs never reseed, so give each voice its own sequence up front
+    lfo1.setRandomSeed(FastRandom::makeSeed(static_cast<juce::uint32>(voiceIndex), 0, lfo1Stream));
+    lfo2.setRandomSeed(FastRandom::makeSeed(static_cast<juce::uint32>(voiceIndex), 0, lfo2Stream));
+}
+
+void SynthVoice::setParaphonic(bool shouldBeParaphonic)
+{
+    paraphonic = shouldBeParaphonic;
+    numOscillatorSlots = paraphonic ? maxParaphonicNotes : 1;
+
+    for (size_t i = 1; i < oscillatorSlots.size(); ++i)
+    {
+        oscillatorSlots[i].noteNumber = -1;
+        oscillatorSlots[i].gain = 0.0f;
+        oscillatorSlots[i].gainTarget = 0.0f;
+    }
+}
+
+void SynthVoice::setGlideTime(float glideMs)
+{
+    if (glideMs != glideTimeMs)
+    {
+        glideTimeMs = juce::jmax(0.0f, glideMs);
+        updateGlideCoefficient();
+    }
+}
+
+void SynthVoice::playMonoNote(int midiNoteNumber, float velocity, bool retrigger)
+{
+    currentNoteNumber = midiNoteNumber;
+    currentVelocity = velocity;
+    isNotePlaying = true;
+    isTailOff = false;
+
+    auto& slot = oscillatorSlots[0];
+    slot.noteNumber = midiNoteNumber;
+    slot.gain = slot.gainTarget = 1.0f;
+
+    // Glide from wherever the pitch currently is
+    targetPitch = static_cast<float>(midiNoteNumber);
+    isGliding = glideTimeMs > 0.0f;
+    if (!isGliding)
+    {
+        currentPitch = targetPitch;
+        updateOscillatorFrequencies();
+    }
+
+    if (retrigger)
+    {
+        ampEnvelope.noteOn();
+        filterEnvelope.noteOn();
+    }
+
+    modMatrix.setVelocity(velocity);
+}
+
+void SynthVoice::addParaphonicNote(int midiNoteNumber, float velocity, bool retrigger)
+{
+    currentNoteNumber = midiNoteNumber;
+    currentVelocity = velocity;
+    isNotePlaying = true;
+    isTailOff = false;
+
+    if (retrigger)
+    {
+        // Fresh phrase: fade out whatever is left ringing from the release tail
+        for (auto& slot : oscillatorSlots)
+            slot.gainTarget = 0.0f;
+
+        ampEnvelope.noteOn();
+        filterEnvelope.noteOn();
+    }
+
+    auto& slot = oscillatorSlots[static_cast<size_t>(assignOscillatorSlot(midiNoteNumber))];
+    slot.gainTarget = 1.0f;
+    slot.oscillator.setFrequency(calculateFrequency(static_cast<float>(midiNoteNumber), currentPitchBend));
+
+    modMatrix.setVelocity(velocity);
+}
+
+void SynthVoice::removeParaphonicNote(int midiNoteNumber)
+{
+    for (int i = 0; i < numOscillatorSlots; ++i)
+    {
+        auto& slot = oscillatorSlots[static_cast<size_t>(i)];
+        if (slot.noteNumber == midiNoteNumber)
+            slot.gainTarget = 0.0f;
+    }
 }
 
 void SynthVoice::setOscillatorWaveform(int waveform)
 {
-    oscillator.setWaveform(waveform);
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setWaveform(waveform);
 }
 
 void SynthVoice::setOscillatorTune(float tuneSemitones)
 {
-    baseOscTune = tuneSemitones;
-    if (currentNoteNumber >= 0)
+    if (tuneSemitones != baseOscTune)
     {
-        float frequency = calculateFrequency(currentNoteNumber, currentPitchBend + tuneSemitones);
-        oscillator.setFrequency(frequency);
+        baseOscTune = tuneSemitones;
+        updateOscillatorFrequencies();
     }
 }
 
+void SynthVoice::setUnison(int numVoices, float detuneCents, float spread)
+{
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setUnison(numVoices, detuneCents, spread);
+}
+
 void SynthVoice::setOscillatorPWM(float pwm)
 {
-    baseOscPWM = pwm;
-    // PWM implementation would go here if oscillator supports it
+    modMatrix.setBaseValue(ModulationMatrix::Osc1PWM, pwm);
+}
+
+void SynthVoice::setOscillator2PWM(float pwm)
+{
+    modMatrix.setBaseValue(ModulationMatrix::Osc2PWM, pwm);
+}
+
+void SynthVoice::setOscillator2Waveform(int waveform)
+{
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setOsc2Waveform(waveform);
+}
+
+void SynthVoice::setOscillator2Tune(float semitones, float cents)
+{
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setOsc2Tune(semitones, cents);
+}
+
+void SynthVoice::setHardSync(bool shouldSync)
+{
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setHardSync(shouldSync);
+}
+
+void SynthVoice::setOscillatorLevels(float osc1, float osc2, float sub, float noise)
+{
+    for (auto& slot : oscillatorSlots)
+        slot.oscillator.setLevels(osc1, osc2, sub, noise);
 }
 
 void SynthVoice::setFilterCutoff(float cutoffHz)
 {
     baseFilterCutoff = cutoffHz;
+    modMatrix.setBaseValue(ModulationMatrix::FilterCutoff, cutoffHz);
 }
 
 void SynthVoice::setFilterResonance(float resonance)
 {
     filter.setResonance(resonance);
+    filterRight.setResonance(resonance);
 }
 
 void SynthVoice::setFilterDrive(float drive)
 {
     filter.setDrive(drive);
+    filterRight.setDrive(drive);
 }
 
 void SynthVoice::setFilterEnvAmount(float amount)
@@ -275,7 +494,32 @@ void SynthVoice::setLFO1ToPitchAmount(float amount)
 
 void SynthVoice::setLFO1ToPWMAmount(float amount)
 {
+    if (amount == lfo1ToPWMAmount)
+        return;
+
+    // LFO 1 sweeps both pulse widths through the matrix; full depth covers its duty-cycle range
     lfo1ToPWMAmount = amount;
+    if (amount > 0.0f)
+    {
+        modMatrix.addConnection(ModulationMatrix::LFO1, ModulationMatrix::Osc1PWM, amount * 0.4f);
+        modMatrix.addConnection(ModulationMatrix::LFO1, ModulationMatrix::Osc2PWM, amount * 0.4f);
+    }
+    else
+    {
+        modMatrix.removeConnection(ModulationMatrix::LFO1, ModulationMatrix::Osc1PWM);
+        modMatrix.removeConnection(ModulationMatrix::LFO1, ModulationMatrix::Osc2PWM);
+    }
+}
+
+void SynthVoice::setLFO1TempoSync(bool shouldSync, int division)
+{
+    lfo1.setTempoSync(shouldSync);
+    lfo1.setDivision(division);
+}
+
+void SynthVoice::setLFO1KeySync(bool shouldRestartOnNote)
+{
+    lfo1.setKeySync(shouldRestartOnNote);
 }
 
 void SynthVoice::setLFO2Rate(float rateHz)
@@ -298,6 +542,23 @@ void SynthVoice::setLFO2ToPitchAmount(float amount)
     lfo2ToPitchAmount = amount;
 }
 
+void SynthVoice::setLFO2TempoSync(bool shouldSync, int division)
+{
+    lfo2.setTempoSync(shouldSync);
+    lfo2.setDivision(division);
+}
+
+void SynthVoice::setLFO2KeySync(bool shouldRestartOnNote)
+{
+    lfo2.setKeySync(shouldRestartOnNote);
+}
+
+void SynthVoice::setTransportPosition(double bpm, double ppqPosition, bool isPlaying)
+{
+    lfo1.syncToTransport(bpm, ppqPosition, isPlaying);
+    lfo2.syncToTransport(bpm, ppqPosition, isPlaying);
+}
+
 void SynthVoice::setModWheelToFilterAmount(float amount)
 {
     modWheelToFilterAmount = amount;
@@ -313,6 +574,45 @@ void SynthVoice::setVelocityToAmpAmount(float amount)
     velocityToAmpAmount = amount;
 }
 
+void SynthVoice::setSequencerModulation(float value)
+{
+    modMatrix.setSequencer(value);
+
+    // The lane only changes on a step, so pitch follows once per block rather than per sample
+    const float pitch = modMatrix.getModulatedValue(ModulationMatrix::Osc1Pitch, {});
+    if (pitch != modulatedPitch)
+    {
+        modulatedPitch = pitch;
+        applyPitchBend();
+    }
+}
+
+void SynthVoice::setSequencerToFilterAmount(float amount)
+{
+    if (amount == sequencerToFilterAmount)
+        return;
+
+    // Full depth moves the cutoff 5 kHz either way, like the mod wheel
+    sequencerToFilterAmount = amount;
+    if (amount != 0.0f)
+        modMatrix.addConnection(ModulationMatrix::Sequencer, ModulationMatrix::FilterCutoff, amount * 5000.0f);
+    else
+        modMatrix.removeConnection(ModulationMatrix::Sequencer, ModulationMatrix::FilterCutoff);
+}
+
+void SynthVoice::setSequencerToPitchAmount(float amount)
+{
+    if (amount == sequencerToPitchAmount)
+        return;
+
+    // Full depth is an octave either way; oscillator 2 keeps its interval to oscillator 1
+    sequencerToPitchAmount = amount;
+    if (amount != 0.0f)
+        modMatrix.addConnection(ModulationMatrix::Sequencer, ModulationMatrix::Osc1Pitch, amount * 12.0f);
+    else
+        modMatrix.removeConnection(ModulationMatrix::Sequencer, ModulationMatrix::Osc1Pitch);
+}
+
 void SynthVoice::setMasterVolume(float volume)
 {
     masterVolume = volume;
@@ -327,30 +627,164 @@ bool SynthVoice::isActive() const
 
 float SynthVoice::getLFO1Value() const
 {
-    return lfo1.getCurrentPhase();
+    return lfo1.getCurrentValue();
 }
 
 float SynthVoice::getLFO2Value() const
 {
-    return lfo2.getCurrentPhase();
+    return lfo2.getCurrentValue();
 }
 
 //==============================================================================
 // Helper functions
-float SynthVoice::calculateFrequency(int midiNoteNumber, float pitchBendSemitones) const
+void SynthVoice::triggerNote(int midiNoteNumber, float velocity, int currentPitchWheelPosition)
+{
+    currentNoteNumber = midiNoteNumber;
+    currentVelocity = velocity;
+    isNotePlaying = true;
+    isTailOff = false;
+
+    // Convert pitch wheel to bend amount (-2 to +2 semitones)
+    currentPitchBend = (currentPitchWheelPosition - 8192) / 8192.0f * 2.0f;
+
+    // A new voice starts on pitch, only slot 0 sounds until more paraphonic notes arrive
+    currentPitch = targetPitch = static_cast<float>(midiNoteNumber);
+    isGliding = false;
+
+    for (auto& slot : oscillatorSlots)
+    {
+        slot.noteNumber = -1;
+        slot.gain = slot.gainTarget = 0.0f;
+    }
+
+    auto& slot = oscillatorSlots[0];
+    slot.noteNumber = midiNoteNumber;
+    slot.gain = slot.gainTarget = 1.0f;
+    slot.startOrder = ++slotStartCounter;
+    slot.oscillator.setNoiseSeed(makeRandomSeed(midiNoteNumber, noiseStream));
+
+    updateOscillatorFrequencies();
+
+    // Trigger envelopes
+    ampEnvelope.noteOn();
+    filterEnvelope.noteOn();
+
+    // Key-synced LFOs restart with every note, free ones keep running.
+    // Random sources are seeded from the voice and note so renders repeat exactly.
+    if (lfo1.isKeySync())
+    {
+        lfo1.setRandomSeed(makeRandomSeed(midiNoteNumber, lfo1Stream));
+        lfo1.reset();
+    }
+    if (lfo2.isKeySync())
+    {
+        lfo2.setRandomSeed(makeRandomSeed(midiNoteNumber, lfo2Stream));
+        lfo2.reset();
+    }
+
+    // Update modulation matrix with velocity
+    modMatrix.setVelocity(velocity);
+}
+
+void SynthVoice::finishKillFade()
+{
+    // The old note is silent now, so its state can be dropped without a click
+    ampEnvelope.reset();
+    filterEnvelope.reset();
+    filter.reset();
+    filterRight.reset();
+
+    if (hasPendingNote)
+    {
+        hasPendingNote = false;
+        triggerNote(pendingNoteNumber, pendingVelocity, pendingPitchWheel);
+    }
+    else if (!isNotePlaying)
+    {
+        releaseVoice();
+    }
+}
+
+void SynthVoice::releaseVoice()
+{
+    clearCurrentNote();
+
+    if (voiceAllocator != nullptr)
+        voiceAllocator->voiceFinished(voiceIndex);
+}
+
+int SynthVoice::assignOscillatorSlot(int midiNoteNumber)
+{
+    int freeSlot = -1;
+    int oldestSlot = 0;
+
+    for (int i = 0; i < numOscillatorSlots; ++i)
+    {
+        const auto& slot = oscillatorSlots[static_cast<size_t>(i)];
+
+        // Re-pressing a note that is still fading out picks its slot back up
+        if (slot.noteNumber == midiNoteNumber)
+            return i;
+
+        if (slot.noteNumber < 0 && freeSlot < 0)
+            freeSlot = i;
+
+        if (slot.startOrder < oscillatorSlots[static_cast<size_t>(oldestSlot)].startOrder)
+            oldestSlot = i;
+    }
+
+    const int index = freeSlot >= 0 ? freeSlot : oldestSlot;
+    auto& slot = oscillatorSlots[static_cast<size_t>(index)];
+
+    if (freeSlot >= 0)
+        slot.gain = 0.0f;
+
+    slot.noteNumber = midiNoteNumber;
+    slot.startOrder = ++slotStartCounter;
+    slot.oscillator.setNoiseSeed(makeRandomSeed(midiNoteNumber, noiseStream + static_cast<juce::uint32>(index)));
+    return index;
+}
+
+juce::uint32 SynthVoice::makeRandomSeed(int midiNoteNumber, juce::uint32 stream) const
+{
+    return FastRandom::makeSeed(static_cast<juce::uint32>(voiceIndex + 1),
+                                static_cast<juce::uint32>(midiNoteNumber), stream);
+}
+
+void SynthVoice::updateOscillatorFrequencies()
+{
+    for (int i = 0; i < numOscillatorSlots; ++i)
+    {
+        auto& slot = oscillatorSlots[static_cast<size_t>(i)];
+        if (slot.noteNumber < 0)
+            continue;
+
+        // Slot 0 follows the (possibly gliding) voice pitch outside paraphonic mode
+        const float pitch = (i == 0 && !paraphonic) ? currentPitch : static_cast<float>(slot.noteNumber);
+        slot.oscillator.setFrequency(calculateFrequency(pitch, currentPitchBend));
+    }
+}
+
+void SynthVoice::updateGlideCoefficient()
+{
+    // One-pole approach that gets within 1% of the target in glideTimeMs
+    if (glideTimeMs <= 0.0f)
+        glideCoeff = 1.0f;
+    else
+        glideCoeff = 1.0f - std::exp(-4.6f / (glideTimeMs * 0.001f * voiceSampleRate));
+}
+
+float SynthVoice::calculateFrequency(float notePitch, float pitchBendSemitones) const
 {
     // MIDI note to frequency conversion: f = 440 * 2^((n-69)/12)
-    float totalSemitones = midiNoteNumber + pitchBendSemitones + baseOscTune;
+    float totalSemitones = notePitch + pitchBendSemitones + baseOscTune + modulatedPitch;
     return 440.0f * std::pow(2.0f, (totalSemitones - 69.0f) / 12.0f);
 }
 
 void SynthVoice::applyPitchBend()
 {
     if (currentNoteNumber >= 0)
-    {
-        float frequency = calculateFrequency(currentNoteNumber, currentPitchBend);
-        oscillator.setFrequency(frequency);
-    }
+        updateOscillatorFrequencies();
 }
 
 void SynthVoice::updateModulationConnections()
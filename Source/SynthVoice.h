@@ -2,12 +2,14 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "Oscillator.h"
+#include "OscillatorBank.h"
 #include "ADSREnvelope.h"
 #include "MoogFilter.h"
 #include "LFO.h"
 #include "ModulationMatrix.h"
 
+class VoiceAllocator;
+
 class SynthVoice : public juce::SynthesiserVoice {
 public:
     SynthVoice();
@@ -24,11 +26,26 @@ public:
     //==============================================================================
     // Parameter setters
     void setSampleRate(double newSampleRate);
+    void setVoiceAllocator(VoiceAllocator* allocator, int index);
+    
+    // Voice mode support (driven by VoiceAllocator)
+    static constexpr int maxParaphonicNotes = 8;
+    void setParaphonic(bool shouldBeParaphonic);
+    void setGlideTime(float glideMs);
+    void playMonoNote(int midiNoteNumber, float velocity, bool retrigger);
+    void addParaphonicNote(int midiNoteNumber, float velocity, bool retrigger);
+    void removeParaphonicNote(int midiNoteNumber);
     
     // Oscillator parameters
     void setOscillatorWaveform(int waveform);
     void setOscillatorTune(float tuneSemitones);
     void setOscillatorPWM(float pwm);
+    void setOscillator2PWM(float pwm);
+    void setUnison(int numVoices, float detuneCents, float spread);
+    void setOscillator2Waveform(int waveform);
+    void setOscillator2Tune(float semitones, float cents);
+    void setHardSync(bool shouldSync);
+    void setOscillatorLevels(float osc1, float osc2, float sub, float noise);
     
     // Filter parameters
     void setFilterCutoff(float cutoffHz);
@@ -53,16 +70,26 @@ public:
     void setLFO1ToFilterAmount(float amount);
     void setLFO1ToPitchAmount(float amount);
     void setLFO1ToPWMAmount(float amount);
+    void setLFO1TempoSync(bool shouldSync, int division);
+    void setLFO1KeySync(bool shouldRestartOnNote);
     
     void setLFO2Rate(float rateHz);
     void setLFO2Waveform(int waveform);
     void setLFO2ToFilterAmount(float amount);
     void setLFO2ToPitchAmount(float amount);
+    void setLFO2TempoSync(bool shouldSync, int division);
+    void setLFO2KeySync(bool shouldRestartOnNote);
+    
+    // Host transport, passed on once per block before rendering
+    void setTransportPosition(double bpm, double ppqPosition, bool isPlaying);
     
     // Modulation parameters
     void setModWheelToFilterAmount(float amount);
     void setVelocityToFilterAmount(float amount);
     void setVelocityToAmpAmount(float amount);
+    void setSequencerModulation(float value);
+    void setSequencerToFilterAmount(float amount);
+    void setSequencerToPitchAmount(float amount);
     
     // Volume
     void setMasterVolume(float volume);
@@ -72,6 +99,9 @@ public:
     bool isActive() const;
     int getCurrentNote() const { return currentNoteNumber; }
     float getCurrentVelocity() const { return currentVelocity; }
+    float getAmpEnvelopeLevel() const { return ampEnvelope.getCurrentLevel(); }
+    float getOutputLevel() const { return outputLevel; } // Peak of the last rendered block
+    bool isWaitingForKillFade() const { return hasPendingNote; } // Stolen, next note not started yet
     
     // Modulation matrix access
     ModulationMatrix& getModMatrix() { return modMatrix; }
@@ -80,12 +110,31 @@ public:
     float getLFO1Value() const;
     float getLFO2Value() const;
 
+    // Oscillator 1 of the voice's own note, for the scope's trigger
+    float getOscillatorPhase() const { return oscillatorSlots[0].oscillator.getPhase(); }
+    float getOscillatorPhaseIncrement() const { return oscillatorSlots[0].oscillator.getPhaseIncrement(); }
+
 private:
     // DSP Components
-    Oscillator oscillator;
+    // Slot 0 plays the voice's own note; the others are only used in paraphonic
+    // mode, where every held note shares this voice's filter and envelopes
+    struct OscillatorSlot {
+        OscillatorBank oscillator;
+        int noteNumber = -1;
+        float gain = 0.0f;
+        float gainTarget = 0.0f;
+        juce::uint32 startOrder = 0;
+    };
+    std::array<OscillatorSlot, maxParaphonicNotes> oscillatorSlots;
+    int numOscillatorSlots = 1;
+    bool paraphonic = false;
+    juce::uint32 slotStartCounter = 0;
+    float slotGainCoeff = 0.005f;
+    
     ADSREnvelope ampEnvelope;
     ADSREnvelope filterEnvelope;
     MoogFilter filter;
+    MoogFilter filterRight; // Only runs when the unison stack is spread in stereo
     
     // Modulation sources
     LFO lfo1;
@@ -100,11 +149,38 @@ private:
     float currentAftertouch = 0.0f;
     bool isNotePlaying = false;
     bool isTailOff = false;
+    float outputLevel = 0.0f;
+    
+    // Voice allocation
+    VoiceAllocator* voiceAllocator = nullptr;
+    int voiceIndex = -1;
+    
+    // Short fade used when a voice is killed or stolen, so the old note
+    // ramps out before the next one starts instead of clicking
+    static constexpr float killFadeTimeMs = 3.0f;
+    int killFadeLength = 132;
+    int killFadeSamplesRemaining = 0;
+    bool hasPendingNote = false;
+    int pendingNoteNumber = -1;
+    float pendingVelocity = 0.0f;
+    int pendingPitchWheel = 8192;
+    
+    // Stream ids for the deterministic random seeds (noise uses one per oscillator slot)
+    static constexpr juce::uint32 lfo1Stream = 1;
+    static constexpr juce::uint32 lfo2Stream = 2;
+    static constexpr juce::uint32 noiseStream = 16;
+    
+    // Portamento, in note numbers so the glide is even across octaves
+    float voiceSampleRate = 44100.0f;
+    float glideTimeMs = 0.0f;
+    float glideCoeff = 1.0f;
+    float currentPitch = 60.0f;
+    float targetPitch = 60.0f;
+    bool isGliding = false;
     
     // Base parameter values
     float baseFilterCutoff = 1000.0f;
     float baseOscTune = 0.0f;
-    float baseOscPWM = 0.5f;
     float masterVolume = 0.7f;
     
     // Modulation amounts
@@ -117,9 +193,19 @@ private:
     float velocityToFilterAmount = 0.0f;
     float velocityToAmpAmount = 1.0f; // Default to full velocity sensitivity
     float filterEnvAmount = 0.5f;
+    float sequencerToFilterAmount = 0.0f;
+    float sequencerToPitchAmount = 0.0f;
+    float modulatedPitch = 0.0f; // Semitones from the matrix, updated per block
     
     // Helper functions
-    float calculateFrequency(int midiNoteNumber, float pitchBend = 0.0f) const;
+    void triggerNote(int midiNoteNumber, float velocity, int currentPitchWheelPosition);
+    void finishKillFade();
+    void releaseVoice();
+    int assignOscillatorSlot(int midiNoteNumber);
+    juce::uint32 makeRandomSeed(int midiNoteNumber, juce::uint32 stream) const;
+    void updateOscillatorFrequencies();
+    void updateGlideCoefficient();
+    float calculateFrequency(float notePitch, float pitchBend = 0.0f) const;
     void applyPitchBend();
     void updateModulationConnections();
     void updateParametersFromModMatrix();
@@ -0,0 +1,350 @@
+// TaskScheduler.cpp
+#include "TaskScheduler.h"
+#include <thread>
+
+//==============================================================================
+void TaskGraph::clear()
+{
+    for (int i = 0; i < numTasks; ++i)
+    {
+        auto& task = tasks[static_cast<size_t>(i)];
+        task.function = nullptr;
+        task.numDependents = 0;
+        task.numPrerequisites = 0;
+    }
+
+    numTasks = 0;
+}
+
+int TaskGraph::addTask(Function&& function)
+{
+    if (numTasks >= maxTasks)
+    {
+        jassertfalse;
+        return -1;
+    }
+
+    auto& task = tasks[static_cast<size_t>(numTasks)];
+    task.function = std::move(function);
+    task.numDependents = 0;
+    task.numPrerequisites = 0;
+    return numTasks++;
+}
+
+void TaskGraph::addDependency(int task, int prerequisite)
+{
+    if (task < 0 || prerequisite < 0)
+        return;
+
+    // Dependencies must point back to earlier tasks
+    jassert(prerequisite < task && task < numTasks);
+
+    auto& before = tasks[static_cast<size_t>(prerequisite)];
+    if (before.numDependents >= maxDependents)
+    {
+        jassertfalse;
+        return;
+    }
+
+    before.dependents[static_cast<size_t>(before.numDependents++)] = task;
+    ++tasks[static_cast<size_t>(task)].numPrerequisites;
+}
+
+//==============================================================================
+// Chase-Lev deque of task ids. The owner pushes and pops at the bottom, other
+// participants steal from the top. Each task is pushed once per run, so the
+// ring never holds more than TaskGraph::maxTasks entries.
+class TaskScheduler::WorkQueue
+{
+public:
+    void reset()
+    {
+        top.store(0);
+        bottom.store(0);
+    }
+
+    void push(int task)
+    {
+        const int b = bottom.load();
+        items[static_cast<size_t>(b & mask)].store(task);
+        bottom.store(b + 1);
+    }
+
+    bool pop(int& task)
+    {
+        const int b = bottom.load() - 1;
+        bottom.store(b);
+        int t = top.load();
+
+        if (t > b)
+        {
+            bottom.store(b + 1);
+            return false;
+        }
+
+        task = items[static_cast<size_t>(b & mask)].load();
+
+        if (t == b)
+        {
+            // Last entry: race any thief for it
+            const bool won = top.compare_exchange_strong(t, t + 1);
+            bottom.store(b + 1);
+            return won;
+        }
+
+        return true;
+    }
+
+    bool steal(int& task)
+    {
+        int t = top.load();
+        const int b = bottom.load();
+
+        if (t >= b)
+            return false;
+
+        task = items[static_cast<size_t>(t & mask)].load();
+        return top.compare_exchange_strong(t, t + 1);
+    }
+
+private:
+    static constexpr int mask = TaskGraph::maxTasks - 1;
+    static_assert((TaskGraph::maxTasks & mask) == 0, "Queue size must be a power of two");
+
+    std::atomic<int> top { 0 };
+    std::atomic<int> bottom { 0 };
+    std::array<std::atomic<int>, TaskGraph::maxTasks> items {};
+};
+
+//==============================================================================
+class TaskScheduler::Worker : public juce::Thread
+{
+public:
+    Worker(TaskScheduler& ownerScheduler, int participantIndex)
+        : juce::Thread("Successor37 Worker " + juce::String(participantIndex)),
+          scheduler(ownerScheduler),
+          participant(participantIndex)
+    {
+    }
+
+    ~Worker() override
+    {
+        stop();
+    }
+
+    void start(int core)
+    {
+        // Pin each worker to its own core; the audio thread is left to the OS
+        if (core >= 0 && core < 32)
+            setAffinityMask(static_cast<juce::uint32>(1) << core);
+
+        if (!startRealtimeThread(juce::Thread::RealtimeOptions{}))
+            startThread(juce::Thread::Priority::highest);
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(1000);
+    }
+
+    void wakeIfSleeping()
+    {
+        if (sleeping.load())
+            wakeEvent.signal();
+    }
+
+    void run() override
+    {
+        double idleSince = juce::Time::getMillisecondCounterHiRes();
+
+        while (!threadShouldExit())
+        {
+            // busyWorkers tells run() when no worker can still be touching its graph
+            scheduler.busyWorkers.fetch_add(1);
+            bool didWork = false;
+            if (auto* graph = scheduler.activeGraph.load())
+                didWork = scheduler.runOneTask(*graph, participant);
+            scheduler.busyWorkers.fetch_sub(1);
+
+            if (didWork)
+            {
+                idleSince = juce::Time::getMillisecondCounterHiRes();
+                continue;
+            }
+
+            // Spin briefly so back-to-back blocks don't pay for a wake-up, then sleep
+            if (juce::Time::getMillisecondCounterHiRes() - idleSince < spinTimeMs)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            sleeping.store(true);
+
+            // Re-check after announcing we're asleep, so a graph started in between isn't missed
+            if (scheduler.activeGraph.load() == nullptr)
+                wakeEvent.wait(100);
+
+            sleeping.store(false);
+            idleSince = juce::Time::getMillisecondCounterHiRes();
+        }
+    }
+
+private:
+    static constexpr double spinTimeMs = 2.0;
+
+    TaskScheduler& scheduler;
+    const int participant;
+    juce::WaitableEvent wakeEvent;
+    std::atomic<bool> sleeping { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+TaskScheduler::TaskScheduler()
+{
+    queues.push_back(std::make_unique<WorkQueue>());
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    release();
+}
+
+void TaskScheduler::prepare(int numWorkers)
+{
+    release();
+
+    numWorkers = juce::jlimit(0, maxWorkers, numWorkers);
+
+    for (int i = 0; i < numWorkers; ++i)
+        queues.push_back(std::make_unique<WorkQueue>());
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i + 1));
+        workers.back()->start(i + 1);
+    }
+}
+
+void TaskScheduler::release()
+{
+    for (auto& worker : workers)
+        worker->stop();
+
+    workers.clear();
+    queues.resize(1);
+}
+
+void TaskScheduler::run(TaskGraph& graph)
+{
+    if (graph.numTasks == 0)
+        return;
+
+    if (deterministic || workers.empty())
+    {
+        runSerial(graph);
+        return;
+    }
+
+    for (auto& queue : queues)
+        queue->reset();
+
+    tasksRemaining.store(graph.numTasks);
+
+    for (int i = 0; i < graph.numTasks; ++i)
+    {
+        auto& task = graph.tasks[static_cast<size_t>(i)];
+        task.pendingPrerequisites.store(task.numPrerequisites);
+    }
+
+    // Push roots in reverse so the calling thread pops them in the order they were added
+    for (int i = graph.numTasks; --i >= 0;)
+        if (graph.tasks[static_cast<size_t>(i)].numPrerequisites == 0)
+            queues[0]->push(i);
+
+    activeGraph.store(&graph);
+
+    for (auto& worker : workers)
+        worker->wakeIfSleeping();
+
+    while (tasksRemaining.load() > 0)
+        if (!runOneTask(graph, 0))
+            std::this_thread::yield();
+
+    // Wait for any worker still looking at this graph before the caller reuses it
+    activeGraph.store(nullptr);
+    while (busyWorkers.load() > 0)
+        std::this_thread::yield();
+}
+
+void TaskScheduler::runSerial(TaskGraph& graph)
+{
+    // Kahn's algorithm, always taking ready tasks in the order they became ready
+    std::array<int, TaskGraph::maxTasks> order;
+    std::array<int, TaskGraph::maxTasks> pending;
+    int numOrdered = 0;
+
+    for (int i = 0; i < graph.numTasks; ++i)
+    {
+        pending[static_cast<size_t>(i)] = graph.tasks[static_cast<size_t>(i)].numPrerequisites;
+        if (pending[static_cast<size_t>(i)] == 0)
+            order[static_cast<size_t>(numOrdered++)] = i;
+    }
+
+    for (int i = 0; i < numOrdered; ++i)
+    {
+        auto& task = graph.tasks[static_cast<size_t>(order[static_cast<size_t>(i)])];
+        task.function();
+
+        for (int d = 0; d < task.numDependents; ++d)
+        {
+            const int dependent = task.dependents[static_cast<size_t>(d)];
+            if (--pending[static_cast<size_t>(dependent)] == 0)
+                order[static_cast<size_t>(numOrdered++)] = dependent;
+        }
+    }
+
+    jassert(numOrdered == graph.numTasks);
+}
+
+bool TaskScheduler::runOneTask(TaskGraph& graph, int participant)
+{
+    int task = -1;
+
+    if (queues[static_cast<size_t>(participant)]->pop(task))
+    {
+        execute(graph, task, participant);
+        return true;
+    }
+
+    const int numQueues = static_cast<int>(queues.size());
+    for (int i = 1; i < numQueues; ++i)
+    {
+        if (queues[static_cast<size_t>((participant + i) % numQueues)]->steal(task))
+        {
+            execute(graph, task, participant);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::execute(TaskGraph& graph, int taskIndex, int participant)
+{
+    auto& task = graph.tasks[static_cast<size_t>(taskIndex)];
+    task.function();
+
+    for (int d = 0; d < task.numDependents; ++d)
+    {
+        const int dependent = task.dependents[static_cast<size_t>(d)];
+        if (graph.tasks[static_cast<size_t>(dependent)].pendingPrerequisites.fetch_sub(1) == 1)
+            queues[static_cast<size_t>(participant)]->push(dependent);
+    }
+
+    tasksRemaining.fetch_sub(1);
+}
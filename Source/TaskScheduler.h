@@ -0,0 +1,97 @@
+// TaskScheduler.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class TaskScheduler;
+
+// A fixed-capacity set of tasks and the order they have to run in.
+// Building a graph never allocates, so it can be filled in on the audio thread
+// every block. A task may only depend on tasks added before it, which keeps the
+// graph free of cycles by construction.
+class TaskGraph
+{
+public:
+    static constexpr int maxTasks = 64;
+    static constexpr int maxDependents = 16;
+    using Function = juce::FixedSizeFunction<48, void()>;
+
+    TaskGraph() = default;
+
+    void clear();
+
+    // Returns the new task's id, or -1 if the graph is full
+    int addTask(Function&& function);
+
+    // task won't start until prerequisite has finished
+    void addDependency(int task, int prerequisite);
+
+    int getNumTasks() const { return numTasks; }
+
+private:
+    friend class TaskScheduler;
+
+    struct Task
+    {
+        Function function;
+        std::array<int, maxDependents> dependents {};
+        int numDependents = 0;
+        int numPrerequisites = 0;
+        std::atomic<int> pendingPrerequisites { 0 };
+    };
+
+    std::array<Task, maxTasks> tasks;
+    int numTasks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(TaskGraph)
+};
+
+// Runs task graphs on the audio thread plus a fixed pool of real-time workers.
+// Each participant has its own lock-free deque: finished tasks push their newly
+// ready dependents onto the local deque, and idle participants steal from the
+// others. No locks are taken and nothing is allocated while a graph runs.
+//
+// In deterministic mode the same graph runs entirely on the calling thread in a
+// fixed order, so parallel output can be compared bit for bit against it.
+class TaskScheduler
+{
+public:
+    static constexpr int maxWorkers = 15;
+
+    TaskScheduler();
+    ~TaskScheduler();
+
+    // Message thread only; numWorkers excludes the calling thread
+    void prepare(int numWorkers);
+    void release();
+
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    void setDeterministic(bool shouldBeDeterministic) { deterministic = shouldBeDeterministic; }
+    bool isDeterministic() const { return deterministic; }
+
+    // Runs every task in the graph and returns once they have all finished
+    void run(TaskGraph& graph);
+
+private:
+    class Worker;
+    class WorkQueue;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues; // queues[0] belongs to the calling thread
+
+    std::atomic<TaskGraph*> activeGraph { nullptr };
+    std::atomic<int> tasksRemaining { 0 };
+    std::atomic<int> busyWorkers { 0 };
+    bool deterministic = false;
+
+    void runSerial(TaskGraph& graph);
+    bool runOneTask(TaskGraph& graph, int participant);
+    void execute(TaskGraph& graph, int taskIndex, int participant);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TaskScheduler)
+};
@@ -0,0 +1,112 @@
+// Telemetry.cpp
+#include "Telemetry.h"
+
+void Telemetry::pushSamples(const juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    // Mono input counts as both channels, so the mix is always (left + right) / 2
+    const int factor = decimation.load(std::memory_order_relaxed);
+    if (decimationCount >= factor)
+    {
+        decimationSum = 0.0f;
+        decimationCount = 0;
+    }
+
+    const float gain = 0.5f / static_cast<float>(factor);
+    const float* left = buffer.getReadPointer(0);
+    const float* right = buffer.getReadPointer(numChannels - 1);
+
+    const int numOut = (decimationCount + numSamples) / factor;
+    const auto scope = sampleFifo.write(numOut);
+    int written = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        decimationSum += left[i] + right[i];
+        if (++decimationCount < factor)
+            continue;
+
+        const float value = decimationSum * gain;
+        decimationSum = 0.0f;
+        decimationCount = 0;
+
+        if (written < scope.blockSize1)
+            samples[static_cast<size_t>(scope.startIndex1 + written)] = value;
+        else if (written < scope.blockSize1 + scope.blockSize2)
+            samples[static_cast<size_t>(scope.startIndex2 + written - scope.blockSize1)] = value;
+        else
+            continue;
+
+        ++written;
+    }
+
+    writePosition += written;
+
+    if (written < numOut)
+        numDropped.fetch_add(numOut - written, std::memory_order_relaxed);
+}
+
+void Telemetry::pushBlockInfo(const BlockInfo& info)
+{
+    const auto scope = blockInfoFifo.write(1);
+    BlockInfo* slot = nullptr;
+    if (scope.blockSize1 > 0)
+        slot = &blockInfos[static_cast<size_t>(scope.startIndex1)];
+    else if (scope.blockSize2 > 0)
+        slot = &blockInfos[static_cast<size_t>(scope.startIndex2)];
+
+    if (slot == nullptr)
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    *slot = info;
+    slot->streamPosition = writePosition;
+}
+
+//==============================================================================
+void Telemetry::attachConsumer()
+{
+    // Whatever is still queued is from before the consumer went away
+    discardPending();
+    consumerAttached.store(true, std::memory_order_release);
+}
+
+void Telemetry::detachConsumer()
+{
+    consumerAttached.store(false, std::memory_order_release);
+}
+
+int Telemetry::readSamples(float* destination, int maxSamples)
+{
+    const auto scope = sampleFifo.read(maxSamples);
+    std::copy_n(samples.begin() + scope.startIndex1, scope.blockSize1, destination);
+    std::copy_n(samples.begin() + scope.startIndex2, scope.blockSize2, destination + scope.blockSize1);
+    readPosition += scope.blockSize1 + scope.blockSize2;
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+bool Telemetry::readLatestBlockInfo(BlockInfo& info)
+{
+    const auto scope = blockInfoFifo.read(blockInfoFifo.getNumReady());
+    if (scope.blockSize2 > 0)
+        info = blockInfos[static_cast<size_t>(scope.startIndex2 + scope.blockSize2 - 1)];
+    else if (scope.blockSize1 > 0)
+        info = blockInfos[static_cast<size_t>(scope.startIndex1 + scope.blockSize1 - 1)];
+    else
+        return false;
+
+    return true;
+}
+
+void Telemetry::discardPending()
+{
+    const auto scope = sampleFifo.read(sampleFifo.getNumReady());
+    readPosition += scope.blockSize1 + scope.blockSize2;
+    blockInfoFifo.read(blockInfoFifo.getNumReady());
+}
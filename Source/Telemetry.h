@@ -0,0 +1,98 @@
+// Telemetry.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "VoiceAllocator.h"
+
+// One-way channel from processBlock to the editor: a stream of output samples (a mono
+// mix, optionally decimated) and one BlockInfo per block with voice, LFO, level and
+// CPU figures. Both are lock-free single-producer/single-consumer FIFOs; the audio
+// thread writes what fits and drops the rest, so it never waits for the editor.
+//
+// Nothing is written unless a consumer is attached, so with the editor closed the
+// audio thread pays one atomic load per block.
+class Telemetry
+{
+public:
+    static constexpr int maxVoices = VoiceAllocator::maxVoices;
+    static constexpr int sampleCapacity = 1 << 15;
+    static constexpr int blockInfoCapacity = 64;
+
+    struct VoiceInfo
+    {
+        int note = -1;          // -1 when the voice is idle
+        float level = 0.0f;     // Amp envelope
+        float lfo1 = 0.0f;
+        float lfo2 = 0.0f;
+        float oscPhase = 0.0f;      // Oscillator 1 at the end of the block, in cycles
+        float oscIncrement = 0.0f;  // Cycles per output sample
+    };
+
+    struct BlockInfo
+    {
+        std::array<VoiceInfo, maxVoices> voices {};
+        int numVoices = 0;
+        std::array<float, 2> outputPeaks {};
+        float cpuLoad = 0.0f;   // Time in processBlock as a proportion of the block's duration
+        int numSamples = 0;
+        double sampleRate = 0.0;
+        juce::int64 streamPosition = 0; // Samples pushed up to the end of this block, after decimation
+    };
+
+    Telemetry() = default;
+
+    //==============================================================================
+    // Audio thread
+    bool isActive() const noexcept { return consumerAttached.load(std::memory_order_acquire); }
+
+    // Averages each run of getDecimation() samples of the channels' mean
+    void pushSamples(const juce::AudioBuffer<float>& buffer);
+    void pushBlockInfo(const BlockInfo& info);
+
+    //==============================================================================
+    // Consumer (one at a time, normally the editor's timer)
+    void attachConsumer();
+    void detachConsumer();
+
+    // 1 (full rate) to 16; the producer picks it up at its next block
+    void setDecimation(int factor) { decimation.store(juce::jlimit(1, 16, factor)); }
+    int getDecimation() const { return decimation.load(); }
+
+    // Returns the number of samples copied, oldest first
+    int readSamples(float* destination, int maxSamples);
+
+    // Position in the sample stream just after the last sample read or discarded.
+    // Compare with BlockInfo::streamPosition to line blocks up with samples.
+    juce::int64 getReadPosition() const { return readPosition; }
+
+    // Drains the block queue, keeping the most recent one. False if there was none.
+    bool readLatestBlockInfo(BlockInfo& info);
+
+    // Samples or blocks dropped because the consumer fell behind
+    int getNumDropped() const { return numDropped.load(); }
+
+private:
+    std::atomic<bool> consumerAttached { false };
+    std::atomic<int> decimation { 2 };
+    std::atomic<int> numDropped { 0 };
+
+    juce::AbstractFifo sampleFifo { sampleCapacity };
+    std::array<float, sampleCapacity> samples {};
+
+    // Decimation runs across block boundaries
+    float decimationSum = 0.0f;
+    int decimationCount = 0;
+
+    // Both count every sample that went through the FIFO; each is owned by one side
+    juce::int64 writePosition = 0;
+    juce::int64 readPosition = 0;
+
+    juce::AbstractFifo blockInfoFifo { blockInfoCapacity };
+    std::array<BlockInfo, blockInfoCapacity> blockInfos {};
+
+    void discardPending();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Telemetry)
+};
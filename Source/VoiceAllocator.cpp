@@ -0,0 +1,383 @@
+// VoiceAllocator.cpp
+#include "VoiceAllocator.h"
+#include "SynthVoice.h"
+
+VoiceAllocator::VoiceAllocator()
+{
+    freeStackPosition.fill(-1);
+}
+
+void VoiceAllocator::initialiseVoices()
+{
+    numSynthVoices = 0;
+    numFreeVoices = 0;
+    freeStackPosition.fill(-1);
+
+    for (int i = 0; i < getNumVoices() && numSynthVoices < maxVoices; ++i)
+    {
+        if (auto* voice = dynamic_cast<SynthVoice*>(getVoice(i)))
+        {
+            const int index = numSynthVoices++;
+            synthVoices[static_cast<size_t>(index)] = voice;
+            voice->setVoiceAllocator(this, index);
+
+            if (!voice->isVoiceActive())
+                voiceFinished(index);
+        }
+    }
+}
+
+void VoiceAllocator::setVoiceMode(int mode)
+{
+    mode = juce::jlimit(0, NumVoiceModes - 1, mode);
+    if (mode == voiceMode)
+        return;
+
+    allNotesOff(0, true);
+    voiceMode = mode;
+
+    for (int i = 0; i < numSynthVoices; ++i)
+        synthVoices[static_cast<size_t>(i)]->setParaphonic(voiceMode == Paraphonic);
+}
+
+void VoiceAllocator::prepareParallelRendering(TaskScheduler& scheduler, int maxBlockSize, int numChannels)
+{
+    renderPool.prepare(scheduler, maxBlockSize, numChannels);
+}
+
+void VoiceAllocator::releaseParallelRendering()
+{
+    renderPool.release();
+}
+
+void VoiceAllocator::setParallelRendering(bool enabled, int minActiveVoices)
+{
+    parallelRenderingEnabled = enabled;
+    parallelVoiceThreshold = juce::jmax(2, minActiveVoices);
+}
+
+//==============================================================================
+void VoiceAllocator::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    if (voiceMode == Poly || numSynthVoices == 0)
+    {
+        juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    addHeldNote(midiNoteNumber, velocity);
+
+    if (voiceMode == Paraphonic)
+        startParaphonicNote(midiChannel, midiNoteNumber, velocity);
+    else
+        updateMonoVoice(midiChannel);
+}
+
+void VoiceAllocator::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    if (voiceMode == Poly || numSynthVoices == 0)
+    {
+        juce::Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    removeHeldNote(midiNoteNumber);
+
+    if (voiceMode == Paraphonic)
+        stopParaphonicNote(midiNoteNumber, velocity, allowTailOff);
+    else
+        updateMonoVoice(midiChannel);
+}
+
+void VoiceAllocator::allNotesOff(int midiChannel, bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    numHeldNotes = 0;
+    monoNote = -1;
+
+    juce::Synthesiser::allNotesOff(midiChannel, allowTailOff);
+}
+
+//==============================================================================
+void VoiceAllocator::addHeldNote(int midiNoteNumber, float velocity)
+{
+    removeHeldNote(midiNoteNumber);
+
+    if (numHeldNotes < static_cast<int>(heldNotes.size()))
+        heldNotes[static_cast<size_t>(numHeldNotes++)] = midiNoteNumber;
+
+    heldVelocities[static_cast<size_t>(midiNoteNumber & 127)] = velocity;
+}
+
+void VoiceAllocator::removeHeldNote(int midiNoteNumber)
+{
+    for (int i = 0; i < numHeldNotes; ++i)
+    {
+        if (heldNotes[static_cast<size_t>(i)] == midiNoteNumber)
+        {
+            for (int j = i + 1; j < numHeldNotes; ++j)
+                heldNotes[static_cast<size_t>(j - 1)] = heldNotes[static_cast<size_t>(j)];
+
+            --numHeldNotes;
+            return;
+        }
+    }
+}
+
+int VoiceAllocator::selectMonoNote() const
+{
+    if (numHeldNotes == 0)
+        return -1;
+
+    switch (notePriority)
+    {
+        case NotePriority::FirstNote:
+            return heldNotes[0];
+
+        case NotePriority::HighestNote:
+            return *std::max_element(heldNotes.begin(), heldNotes.begin() + numHeldNotes);
+
+        case NotePriority::LowestNote:
+            return *std::min_element(heldNotes.begin(), heldNotes.begin() + numHeldNotes);
+
+        case NotePriority::LastNote:
+        default:
+            return heldNotes[static_cast<size_t>(numHeldNotes - 1)];
+    }
+}
+
+void VoiceAllocator::updateMonoVoice(int midiChannel)
+{
+    auto* voice = synthVoices[0];
+    const int note = selectMonoNote();
+
+    if (note < 0)
+    {
+        // Last key released
+        if (voice->isVoiceActive())
+            stopVoice(voice, 0.0f, true);
+
+        monoNote = -1;
+        return;
+    }
+
+    if (note == monoNote)
+        return;
+
+    const float velocity = heldVelocities[static_cast<size_t>(note)];
+
+    if (!voice->isVoiceActive())
+    {
+        startVoice(voice, getSound(0).get(), midiChannel, note, velocity);
+    }
+    else
+    {
+        // Legato only retriggers when the previous note had already been released
+        const bool retrigger = voiceMode == Mono || monoNote < 0;
+        voice->playMonoNote(note, velocity, retrigger);
+    }
+
+    monoNote = note;
+}
+
+void VoiceAllocator::startParaphonicNote(int midiChannel, int midiNoteNumber, float velocity)
+{
+    auto* voice = synthVoices[0];
+
+    if (!voice->isVoiceActive())
+        startVoice(voice, getSound(0).get(), midiChannel, midiNoteNumber, velocity);
+    else
+        voice->addParaphonicNote(midiNoteNumber, velocity, numHeldNotes == 1);
+}
+
+void VoiceAllocator::stopParaphonicNote(int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    auto* voice = synthVoices[0];
+
+    // The last key lets the shared envelope release with its oscillator still running
+    if (numHeldNotes == 0)
+    {
+        if (voice->isVoiceActive())
+            stopVoice(voice, velocity, allowTailOff);
+    }
+    else
+    {
+        voice->removeParaphonicNote(midiNoteNumber);
+    }
+}
+
+//==============================================================================
+void VoiceAllocator::voiceStarted(int voiceIndex)
+{
+    const int position = freeStackPosition[static_cast<size_t>(voiceIndex)];
+    if (position < 0)
+        return;
+
+    // Swap-remove: move the top of the stack into the vacated slot
+    const int lastIndex = freeStack[static_cast<size_t>(numFreeVoices - 1)];
+    freeStack[static_cast<size_t>(position)] = lastIndex;
+    freeStackPosition[static_cast<size_t>(lastIndex)] = position;
+    freeStackPosition[static_cast<size_t>(voiceIndex)] = -1;
+    --numFreeVoices;
+}
+
+void VoiceAllocator::voiceFinished(int voiceIndex)
+{
+    if (parallelRenderInProgress)
+    {
+        finishedDuringRender[static_cast<size_t>(voiceIndex)] = true;
+        return;
+    }
+
+    if (freeStackPosition[static_cast<size_t>(voiceIndex)] >= 0)
+        return;
+
+    freeStack[static_cast<size_t>(numFreeVoices)] = voiceIndex;
+    freeStackPosition[static_cast<size_t>(voiceIndex)] = numFreeVoices;
+    ++numFreeVoices;
+}
+
+//==============================================================================
+void VoiceAllocator::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    if (parallelRenderingEnabled && numSamples >= minParallelBlockSize
+        && renderPool.canRender(outputAudio, numSamples))
+    {
+        int numActive = 0;
+        for (int i = 0; i < numSynthVoices; ++i)
+            if (synthVoices[static_cast<size_t>(i)]->isActive())
+                ++numActive;
+
+        if (numActive >= parallelVoiceThreshold)
+        {
+            // Idle voices only advance their LFOs, which is cheap enough to do here
+            numActive = 0;
+            for (int i = 0; i < numSynthVoices; ++i)
+            {
+                auto* voice = synthVoices[static_cast<size_t>(i)];
+                if (voice->isActive())
+                    activeVoices[static_cast<size_t>(numActive++)] = voice;
+                else
+                    voice->renderNextBlock(outputAudio, startSample, numSamples);
+            }
+
+            parallelRenderInProgress = true;
+            renderPool.render(activeVoices.data(), numActive, outputAudio, startSample, numSamples);
+            parallelRenderInProgress = false;
+
+            for (int i = 0; i < numSynthVoices; ++i)
+            {
+                if (finishedDuringRender[static_cast<size_t>(i)])
+                {
+                    finishedDuringRender[static_cast<size_t>(i)] = false;
+                    voiceFinished(i);
+                }
+            }
+            return;
+        }
+    }
+
+    juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+}
+
+//==============================================================================
+juce::SynthesiserVoice* VoiceAllocator::findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                                      int midiNoteNumber, bool stealIfNoneAvailable) const
+{
+    if (numSynthVoices == 0)
+        return juce::Synthesiser::findFreeVoice(soundToPlay, midiChannel, midiNoteNumber, stealIfNoneAvailable);
+
+    if (numFreeVoices > 0)
+        return synthVoices[static_cast<size_t>(freeStack[static_cast<size_t>(numFreeVoices - 1)])];
+
+    if (!stealIfNoneAvailable)
+        return nullptr;
+
+    // Voices whose keys are already up are fair game whatever the priority
+    if (auto* released = findStealCandidate(true))
+        return released;
+
+    switch (notePriority)
+    {
+        case NotePriority::FirstNote:
+            // Held notes win, the new note is dropped
+            return nullptr;
+
+        case NotePriority::HighestNote:
+        case NotePriority::LowestNote:
+        {
+            const bool preferHigh = notePriority == NotePriority::HighestNote;
+            SynthVoice* weakest = nullptr;
+
+            for (int i = 0; i < numSynthVoices; ++i)
+            {
+                auto* voice = synthVoices[static_cast<size_t>(i)];
+                if (weakest == nullptr
+                    || (preferHigh ? voice->getCurrentlyPlayingNote() < weakest->getCurrentlyPlayingNote()
+                                   : voice->getCurrentlyPlayingNote() > weakest->getCurrentlyPlayingNote()))
+                    weakest = voice;
+            }
+
+            if (weakest != nullptr
+                && (preferHigh ? midiNoteNumber > weakest->getCurrentlyPlayingNote()
+                               : midiNoteNumber < weakest->getCurrentlyPlayingNote()))
+                return weakest;
+
+            return nullptr;
+        }
+
+        case NotePriority::LastNote:
+        default:
+            return findVoiceToSteal(soundToPlay, midiChannel, midiNoteNumber);
+    }
+}
+
+juce::SynthesiserVoice* VoiceAllocator::findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                                         int midiNoteNumber) const
+{
+    juce::ignoreUnused(soundToPlay, midiChannel, midiNoteNumber);
+
+    if (auto* released = findStealCandidate(true))
+        return released;
+
+    return findStealCandidate(false);
+}
+
+SynthVoice* VoiceAllocator::findStealCandidate(bool releasedOnly) const
+{
+    SynthVoice* best = nullptr;
+
+    for (int i = 0; i < numSynthVoices; ++i)
+    {
+        auto* voice = synthVoices[static_cast<size_t>(i)];
+
+        if (releasedOnly && !voice->isPlayingButReleased())
+            continue;
+
+        if (best == nullptr || isBetterStealCandidate(*voice, *best))
+            best = voice;
+    }
+
+    return best;
+}
+
+bool VoiceAllocator::isBetterStealCandidate(const SynthVoice& candidate, const SynthVoice& current) const
+{
+    switch (stealMode)
+    {
+        case Quietest:
+            return candidate.getOutputLevel() < current.getOutputLevel();
+
+        case LowestEnvelope:
+            return candidate.getAmpEnvelopeLevel() < current.getAmpEnvelopeLevel();
+
+        case Oldest:
+        default:
+            return candidate.wasStartedBefore(current);
+    }
+}
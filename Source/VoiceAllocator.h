@@ -0,0 +1,115 @@
+// VoiceAllocator.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "VoiceRenderPool.h"
+
+class SynthVoice;
+
+enum class NotePriority {
+    LastNote,
+    FirstNote,
+    HighestNote,
+    LowestNote
+};
+
+class VoiceAllocator : public juce::Synthesiser
+{
+public:
+    // How a busy voice is chosen when a new note needs one
+    enum StealMode {
+        Oldest = 0,
+        Quietest,
+        LowestEnvelope,
+        NumStealModes
+    };
+
+    enum VoiceMode {
+        Poly = 0,
+        Mono,       // Single voice, envelopes retrigger on every new note
+        Legato,     // Single voice, overlapping notes glide without retriggering
+        Paraphonic, // One filter/amp chain shared by several oscillators
+        NumVoiceModes
+    };
+
+    static constexpr int maxVoices = 32;
+
+    VoiceAllocator();
+
+    // Call after all voices have been added with addVoice()
+    void initialiseVoices();
+
+    void setNotePriority(NotePriority priority) { notePriority = priority; }
+    void setStealMode(int mode) { stealMode = juce::jlimit(0, NumStealModes - 1, mode); }
+    void setVoiceMode(int mode);
+
+    // Multi-core rendering on the scheduler's workers (prepare on the message thread),
+    // only used for blocks with at least minActiveVoices sounding
+    void prepareParallelRendering(TaskScheduler& scheduler, int maxBlockSize, int numChannels);
+    void releaseParallelRendering();
+    void setParallelRendering(bool enabled, int minActiveVoices);
+
+    NotePriority getNotePriority() const { return notePriority; }
+    int getVoiceMode() const { return voiceMode; }
+    int getNumFreeVoices() const { return numFreeVoices; }
+    SynthVoice* getSynthVoice(int index) const { return synthVoices[static_cast<size_t>(index)]; } // After initialiseVoices()
+
+    // Free-list bookkeeping, called by SynthVoice on the audio thread
+    void voiceStarted(int voiceIndex);
+    void voiceFinished(int voiceIndex);
+
+    // juce::Synthesiser overrides, so the single-voice modes can track held notes
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+    void allNotesOff(int midiChannel, bool allowTailOff) override;
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+    juce::SynthesiserVoice* findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                          int midiNoteNumber, bool stealIfNoneAvailable) const override;
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                             int midiNoteNumber) const override;
+
+private:
+    NotePriority notePriority = NotePriority::LastNote;
+    int stealMode = Oldest;
+
+    // Voices indexed by their position in the synth, plus a stack of free indices.
+    // freeStackPosition[i] is the slot of voice i in freeStack, or -1 if it is busy.
+    std::array<SynthVoice*, maxVoices> synthVoices {};
+    std::array<int, maxVoices> freeStack {};
+    std::array<int, maxVoices> freeStackPosition {};
+    int numSynthVoices = 0;
+    int numFreeVoices = 0;
+
+    // Held keys in the order they were pressed, used by the Mono/Legato/Paraphonic modes
+    int voiceMode = Poly;
+    std::array<int, 128> heldNotes {};
+    std::array<float, 128> heldVelocities {};
+    int numHeldNotes = 0;
+    int monoNote = -1;
+
+    void addHeldNote(int midiNoteNumber, float velocity);
+    void removeHeldNote(int midiNoteNumber);
+    int selectMonoNote() const;
+    void updateMonoVoice(int midiChannel);
+    void startParaphonicNote(int midiChannel, int midiNoteNumber, float velocity);
+    void stopParaphonicNote(int midiNoteNumber, float velocity, bool allowTailOff);
+
+    // Parallel rendering. Voices that finish on a worker thread are only marked,
+    // the free list is updated afterwards on the audio thread.
+    static constexpr int minParallelBlockSize = 32;
+    VoiceRenderPool renderPool;
+    bool parallelRenderingEnabled = false;
+    int parallelVoiceThreshold = 4;
+    bool parallelRenderInProgress = false;
+    std::array<juce::SynthesiserVoice*, maxVoices> activeVoices {};
+    std::array<bool, maxVoices> finishedDuringRender {};
+
+    SynthVoice* findStealCandidate(bool releasedOnly) const;
+    bool isBetterStealCandidate(const SynthVoice& candidate, const SynthVoice& current) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceAllocator)
+};
@@ -0,0 +1,72 @@
+// VoiceRenderPool.cpp
+#include "VoiceRenderPool.h"
+
+VoiceRenderPool::VoiceRenderPool()
+{
+}
+
+void VoiceRenderPool::prepare(TaskScheduler& newScheduler, int maxBlockSize, int numChannels)
+{
+    release();
+
+    if (maxBlockSize <= 0 || numChannels <= 0)
+        return;
+
+    scheduler = &newScheduler;
+    preparedBlockSize = maxBlockSize;
+    preparedChannels = numChannels;
+
+    const int numGroups = juce::jmin(maxGroups, scheduler->getNumWorkers() + 1);
+    for (int i = 0; i < numGroups; ++i)
+        scratchBuffers.push_back(std::make_unique<juce::AudioBuffer<float>>(numChannels, maxBlockSize));
+}
+
+void VoiceRenderPool::release()
+{
+    scheduler = nullptr;
+    scratchBuffers.clear();
+    preparedBlockSize = 0;
+    preparedChannels = 0;
+}
+
+bool VoiceRenderPool::canRender(const juce::AudioBuffer<float>& buffer, int numSamples) const
+{
+    return scheduler != nullptr
+        && scratchBuffers.size() > 1
+        && numSamples <= preparedBlockSize
+        && buffer.getNumChannels() == preparedChannels;
+}
+
+void VoiceRenderPool::render(juce::SynthesiserVoice* const* voices, int numVoices,
+                             juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert(canRender(buffer, numSamples));
+
+    jobVoices = voices;
+    jobNumVoices = numVoices;
+    jobNumSamples = numSamples;
+    jobNumGroups = juce::jmin(static_cast<int>(scratchBuffers.size()), numVoices);
+
+    graph.clear();
+    for (int group = 0; group < jobNumGroups; ++group)
+        graph.addTask([this, group] { renderGroup(group); });
+
+    scheduler->run(graph);
+
+    // Sum in group order so the result doesn't depend on thread timing
+    for (int group = 0; group < jobNumGroups; ++group)
+    {
+        const auto& scratch = *scratchBuffers[static_cast<size_t>(group)];
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.addFrom(channel, startSample, scratch, channel, 0, numSamples);
+    }
+}
+
+void VoiceRenderPool::renderGroup(int group)
+{
+    auto& scratch = *scratchBuffers[static_cast<size_t>(group)];
+    scratch.clear(0, jobNumSamples);
+
+    for (int i = group; i < jobNumVoices; i += jobNumGroups)
+        jobVoices[i]->renderNextBlock(scratch, 0, jobNumSamples);
+}
@@ -0,0 +1,52 @@
+// VoiceRenderPool.h
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+#include "TaskScheduler.h"
+
+// Renders synth voices in parallel on a TaskScheduler.
+// Scratch buffers are created in prepare(); render() itself never allocates or
+// takes a lock. Voices are split into one round-robin group per participating
+// thread, each group renders into its own scratch buffer as a task, and the
+// buffers are summed into the output on the calling thread.
+//
+// Groups are fixed rather than claimed on demand and summed in group order, so
+// which thread ran a group never changes the result.
+class VoiceRenderPool
+{
+public:
+    static constexpr int maxGroups = TaskScheduler::maxWorkers + 1;
+
+    VoiceRenderPool();
+
+    // Message thread only
+    void prepare(TaskScheduler& scheduler, int maxBlockSize, int numChannels);
+    void release();
+
+    bool canRender(const juce::AudioBuffer<float>& buffer, int numSamples) const;
+
+    // Renders the given voices into buffer, adding to what is already there
+    void render(juce::SynthesiserVoice* const* voices, int numVoices,
+                juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    TaskScheduler* scheduler = nullptr;
+    TaskGraph graph;
+
+    // One scratch buffer per voice group
+    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> scratchBuffers;
+    int preparedBlockSize = 0;
+    int preparedChannels = 0;
+
+    // Current job
+    juce::SynthesiserVoice* const* jobVoices = nullptr;
+    int jobNumVoices = 0;
+    int jobNumSamples = 0;
+    int jobNumGroups = 1;
+
+    void renderGroup(int group);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceRenderPool)
+};